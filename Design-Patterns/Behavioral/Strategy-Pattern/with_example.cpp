@@ -12,28 +12,28 @@ public:
 class CreditCardGateway : public IPaymentGateway {
 public:
     void pay(float amount) override {
-        cout << "Processing credit card payment of $" << amount << endl;
+        cout << "Processing credit card payment of $" << amount << '\n';
     }
 };
 
 class PayPalGateway : public IPaymentGateway {
 public:
     void pay(float amount) override {
-        cout << "Processing PayPal payment of $" << amount << endl;
+        cout << "Processing PayPal payment of $" << amount << '\n';
     }
 };
 
 class CryptoGateway : public IPaymentGateway {
 public:
     void pay(float amount) override {
-        cout << "Processing Crypto payment of $" << amount << endl;
+        cout << "Processing Crypto payment of $" << amount << '\n';
     }
 };
 
 class ApplePayGateway : public IPaymentGateway {
 public:
     void pay(float amount) override {
-        cout << "Processing Apple Pay payment of $" << amount << endl;
+        cout << "Processing Apple Pay payment of $" << amount << '\n';
     }
 };
 
@@ -48,7 +48,7 @@ public:
 
     void processPayment(float amount) {
         if (!gateway) {
-            cout << "Error: No payment gateway selected!" << endl;
+            cout << "Error: No payment gateway selected!\n";
             return;
         }
         gateway->pay(amount);
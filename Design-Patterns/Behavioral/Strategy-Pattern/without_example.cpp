@@ -7,7 +7,7 @@ using namespace std;
 class PaymentProcessor {
 public:
     virtual void processPayment(double amount) {
-        cout << "Processing generic payment of $" << amount << endl;
+        cout << "Processing generic payment of $" << amount << '\n';
     }
 
     virtual ~PaymentProcessor() = default;
@@ -17,7 +17,7 @@ public:
 class CreditCardProcessor : public PaymentProcessor {
 public:
     void processPayment(double amount) override {
-        cout << "Processing credit card payment of $" << amount << endl;
+        cout << "Processing credit card payment of $" << amount << '\n';
     }
 };
 
@@ -25,7 +25,7 @@ public:
 class PayPalProcessor : public PaymentProcessor {
 public:
     void processPayment(double amount) override {
-        cout << "Processing PayPal payment of $" << amount << endl;
+        cout << "Processing PayPal payment of $" << amount << '\n';
     }
 };
 
@@ -33,7 +33,7 @@ public:
 class CryptoProcessor : public PaymentProcessor {
 public:
     void processPayment(double amount) override {
-        cout << "Processing cryptocurrency payment of $" << amount << endl;
+        cout << "Processing cryptocurrency payment of $" << amount << '\n';
     }
 };
 
@@ -50,10 +50,10 @@ int main() {
     cin >> amount;
 
     while (true) {
-        cout << "Choose your payment method: " << endl;
-        cout << "1. credit Card" << endl;
-        cout << "2. payPal" << endl;
-        cout << "3. crypto" << endl;
+        cout << "Choose your payment method: \n";
+        cout << "1. credit Card\n";
+        cout << "2. payPal\n";
+        cout << "3. crypto\n";
         cin >> choice;
 
         switch (choice) {
@@ -67,11 +67,11 @@ int main() {
             paymentProcessor = new CryptoProcessor();
             break;
         default:
-            cout << "Invalid choice. Try again." << endl;
+            cout << "Invalid choice. Try again.\n";
             continue; // go back to start
         }
 
-        cout << "Are you sure of that payment method? (reply with Y or y for yes)" << endl;
+        cout << "Are you sure of that payment method? (reply with Y or y for yes)\n";
         char confirmation;
         cin >> confirmation;
 
@@ -79,7 +79,7 @@ int main() {
             paymentProcessor->processPayment(amount);
             break; // exit loop after confirmation
         } else {
-            cout << "payment method not confirmed" << endl;
+            cout << "payment method not confirmed\n";
         }
     }
 
@@ -1,28 +1,248 @@
 #include <iostream>
 #include <string>
 #include <iomanip> 
+#include <vector>
+#include <numeric>
+#include <memory>
+#include <queue>
+#include <future>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <array>
+#include <deque>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <sstream>
+#include <cmath>
+#include <cstring>
+#include <string_view>
 
 // Define the Incompatible Third-Party Services (Adaptees)
 // These are the classes with interfaces that our system doesn't control.
 using namespace std;
+
+// Async log
+// Writing a line to cout takes a lock and, whenever the stream's buffer
+// fills up, a system call, both on the thread that is making the payment.
+// AsyncLog gives every thread a ring buffer of its own instead: write()
+// copies the line into it without taking any lock, and one background thread
+// moves the lines from all the rings to the real stream every millisecond.
+// The lines of one thread stay in order. Lines of different threads are only
+// ordered across a flush(): everything written before it comes out first.
+// Nothing else may write to the same stream while the log is open.
+class AsyncLog {
+private:
+    static constexpr size_t kRingBytes = 1 << 16;
+
+    // One writer (its thread) and one reader (the flusher). Positions only
+    // grow; the byte for position p is bytes[p % kRingBytes].
+    struct Ring {
+        array<char, kRingBytes> bytes;
+        alignas(64) atomic<size_t> head{0}; // moved on by the flusher
+        alignas(64) atomic<size_t> tail{0}; // moved on by the writing thread
+    };
+
+    ostream& out;
+    const uint64_t id; // tells this log apart in the threads' caches
+    vector<unique_ptr<Ring>> rings;
+    mutex ringsLock;
+
+    mutex wakeLock;
+    condition_variable wake;      // the flusher waits on this
+    condition_variable flushed;   // flush() callers wait on this
+    uint64_t flushesRequested = 0;
+    uint64_t flushesDone = 0;
+    bool stopping = false;
+    thread flusher;
+
+    static uint64_t nextId() {
+        static atomic<uint64_t> counter{1};
+        return counter++;
+    }
+
+    // The calling thread's ring, made on its first write to this log.
+    Ring& localRing() {
+        struct Cache {
+            uint64_t logId = 0;
+            Ring* ring = nullptr;
+        };
+        thread_local Cache cache;
+        if (cache.logId == id) return *cache.ring;
+
+        thread_local unordered_map<uint64_t, Ring*> mine;
+        Ring*& ring = mine[id];
+        if (!ring) {
+            lock_guard<mutex> guard(ringsLock);
+            rings.push_back(make_unique<Ring>());
+            ring = rings.back().get();
+        }
+        cache = {id, ring};
+        return *ring;
+    }
+
+    // Writes out whatever the rings hold right now.
+    void drain() {
+        lock_guard<mutex> guard(ringsLock);
+        for (auto& ring : rings) {
+            size_t head = ring->head.load(memory_order_relaxed);
+            size_t tail = ring->tail.load(memory_order_acquire);
+            while (head != tail) {
+                size_t offset = head % kRingBytes;
+                size_t length = min(tail - head, kRingBytes - offset);
+                out.write(ring->bytes.data() + offset, streamsize(length));
+                head += length;
+            }
+            ring->head.store(head, memory_order_release);
+        }
+        out.flush();
+    }
+
+    void run() {
+        unique_lock<mutex> guard(wakeLock);
+        while (true) {
+            wake.wait_for(guard, chrono::milliseconds(1),
+                          [this] { return stopping || flushesRequested != flushesDone; });
+            uint64_t requested = flushesRequested;
+            bool stop = stopping;
+            guard.unlock();
+            drain();
+            guard.lock();
+            flushesDone = requested;
+            flushed.notify_all();
+            if (stop) return;
+        }
+    }
+
+public:
+    explicit AsyncLog(ostream& target) : out(target), id(nextId()) {
+        flusher = thread(&AsyncLog::run, this);
+    }
+
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    // Every line written before this is out once the flusher stops.
+    ~AsyncLog() {
+        {
+            lock_guard<mutex> guard(wakeLock);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+    }
+
+    // A line is handed to the flusher whole, so lines of different threads
+    // never mix. Only text longer than the ring goes out in pieces.
+    void write(string_view text) {
+        Ring& ring = localRing();
+        size_t tail = ring.tail.load(memory_order_relaxed);
+        while (!text.empty()) {
+            size_t piece = min(text.size(), kRingBytes);
+            if (kRingBytes - (tail - ring.head.load(memory_order_acquire)) < piece) {
+                // The flusher is behind: wake it and wait for room
+                wake.notify_one();
+                this_thread::yield();
+                continue;
+            }
+            size_t offset = tail % kRingBytes;
+            size_t first = min(piece, kRingBytes - offset); // up to the end of the ring
+            memcpy(ring.bytes.data() + offset, text.data(), first);
+            memcpy(ring.bytes.data(), text.data() + first, piece - first);
+            tail += piece;
+            text.remove_prefix(piece);
+            ring.tail.store(tail, memory_order_release);
+        }
+    }
+
+    // Waits until everything written so far, by any thread, is in the stream.
+    void flush() {
+        unique_lock<mutex> guard(wakeLock);
+        uint64_t ticket = ++flushesRequested;
+        wake.notify_one();
+        flushed.wait(guard, [this, ticket] { return flushesDone >= ticket; });
+    }
+};
+
+// Some calls below run on worker threads (see the connection pool). Each
+// line is built in its own buffer and written to cout in one go under a
+// short lock, so lines from different threads never mix and no thread
+// changes cout's formatting under another one.
+// With sendTo() the finished lines go to an AsyncLog instead, and the
+// calling thread never waits on cout.
+class ConsoleLine {
+private:
+    ostringstream line;
+    inline static mutex lock;
+    inline static atomic<AsyncLog*> asyncLog{nullptr};
+
+public:
+    // nullptr goes back to cout. Only switch while no calls are running,
+    // and keep the log alive until switched away from it.
+    static void sendTo(AsyncLog* log) {
+        asyncLog.store(log, memory_order_release);
+    }
+
+    template <typename T>
+    ConsoleLine& operator<<(const T& value) {
+        line << value;
+        return *this;
+    }
+
+    ~ConsoleLine() {
+        if (AsyncLog* log = asyncLog.load(memory_order_acquire)) {
+            log->write(line.str());
+            return;
+        }
+        lock_guard<mutex> guard(lock);
+        cout << line.str();
+    }
+};
+
 class StripeAPI {
 public:
     /**
      * @brief Processes a payment in cents.
      */
     void charge(const string& cardDetails, int amountCents) {
-        cout << "Stripe: Charging card '" << cardDetails << "' for "
+        ConsoleLine() << "Stripe: Charging card '" << cardDetails << "' for "
              << fixed << setprecision(2) << static_cast<double>(amountCents) / 100.0
-             << " USD." << endl;
+             << " USD.\n";
     }
 
     /**
      * @brief Issues a refund in cents.
      */
     void issueRefund(const string& transactionId, int amountCents) {
-        cout << "Stripe: Refunding "
+        ConsoleLine() << "Stripe: Refunding "
              << fixed << setprecision(2) << static_cast<double>(amountCents) / 100.0
-             << " USD for transaction '" << transactionId << "'." << endl;
+             << " USD for transaction '" << transactionId << "'.\n";
+    }
+
+    /**
+     * @brief Processes many payments in cents with a single request.
+     */
+    void chargeBatch(const string& cardDetails, const vector<int>& amountsCents) {
+        long long totalCents = accumulate(amountsCents.begin(), amountsCents.end(), 0LL);
+        ConsoleLine() << "Stripe: Charging card '" << cardDetails << "' for "
+             << amountsCents.size() << " payments, total "
+             << fixed << setprecision(2) << static_cast<double>(totalCents) / 100.0
+             << " USD.\n";
+    }
+
+    /**
+     * @brief Issues many refunds in cents with a single request.
+     */
+    void issueRefundBatch(const string& transactionId, const vector<int>& amountsCents) {
+        long long totalCents = accumulate(amountsCents.begin(), amountsCents.end(), 0LL);
+        ConsoleLine() << "Stripe: Refunding " << amountsCents.size() << " amounts, total "
+             << fixed << setprecision(2) << static_cast<double>(totalCents) / 100.0
+             << " USD for transaction '" << transactionId << "'.\n";
     }
 };
 
@@ -32,18 +252,38 @@ public:
      * @brief Sends a payment in dollars.
      */
     void sendPayment(const string& email, double amountDollars) {
-        cout << "PayPal: Sending payment of "
+        ConsoleLine() << "PayPal: Sending payment of "
              << fixed << setprecision(2) << amountDollars
-             << " USD to '" << email << "'." << endl;
+             << " USD to '" << email << "'.\n";
     }
 
     /**
      * @brief Reverses a payment in dollars.
      */
     void reversePayment(const string& paymentId, double amountDollars) {
-        cout << "PayPal: Reversing payment of "
+        ConsoleLine() << "PayPal: Reversing payment of "
              << fixed << setprecision(2) << amountDollars
-             << " USD for payment ID '" << paymentId << "'." << endl;
+             << " USD for payment ID '" << paymentId << "'.\n";
+    }
+
+    /**
+     * @brief Sends many payments in dollars with a single request.
+     */
+    void sendPaymentBatch(const string& email, const vector<double>& amountsDollars) {
+        double total = accumulate(amountsDollars.begin(), amountsDollars.end(), 0.0);
+        ConsoleLine() << "PayPal: Sending " << amountsDollars.size() << " payments, total "
+             << fixed << setprecision(2) << total
+             << " USD to '" << email << "'.\n";
+    }
+
+    /**
+     * @brief Reverses many payments in dollars with a single request.
+     */
+    void reversePaymentBatch(const string& paymentId, const vector<double>& amountsDollars) {
+        double total = accumulate(amountsDollars.begin(), amountsDollars.end(), 0.0);
+        ConsoleLine() << "PayPal: Reversing " << amountsDollars.size() << " payments, total "
+             << fixed << setprecision(2) << total
+             << " USD for payment ID '" << paymentId << "'.\n";
     }
 };
 
@@ -56,6 +296,15 @@ public:
     virtual ~IPaymentGateway() = default; // Virtual destructor for base class
     virtual void pay(double amount) = 0;
     virtual void refund(double amount) = 0;
+
+    // Batch versions of the calls above. By default they just loop, so an
+    // adapter only overrides them when its provider can take a whole batch.
+    virtual void payBatch(const vector<double>& amounts) {
+        for (double amount : amounts) pay(amount);
+    }
+    virtual void refundBatch(const vector<double>& amounts) {
+        for (double amount : amounts) refund(amount);
+    }
 };
 
 // Create the Adapters 
@@ -68,6 +317,20 @@ private:
     string cardDetails;
     string transactionId;
 
+    // The dollars-to-cents rule lives in one place for single and batch calls.
+    // Rounded, not truncated: 0.29 * 100 is 28.999... in a double.
+    static int toCents(double amount) {
+        return static_cast<int>(llround(amount * 100));
+    }
+
+    static vector<int> toCents(const vector<double>& amounts) {
+        vector<int> cents(amounts.size());
+        for (size_t i = 0; i < amounts.size(); ++i) {
+            cents[i] = toCents(amounts[i]);
+        }
+        return cents;
+    }
+
 public:
     StripeAdapter(StripeAPI* api, string card, string txnId)
         : stripeApi(api), cardDetails(card), transactionId(txnId) {}
@@ -77,8 +340,8 @@ public:
      * converting the amount from dollars to cents.
      */
     void pay(double amount) override {
-        int amountInCents = static_cast<int>(amount * 100);
-        cout << "StripeAdapter: Converting amount to cents and calling Stripe API." << endl;
+        int amountInCents = toCents(amount);
+        ConsoleLine() << "StripeAdapter: Converting amount to cents and calling Stripe API.\n";
         stripeApi->charge(cardDetails, amountInCents);
     }
 
@@ -87,10 +350,24 @@ public:
      * converting the amount from dollars to cents.
      */
     void refund(double amount) override {
-        int amountInCents = static_cast<int>(amount * 100);
-        cout << "StripeAdapter: Converting amount to cents and calling Stripe API for refund." << endl;
+        int amountInCents = toCents(amount);
+        ConsoleLine() << "StripeAdapter: Converting amount to cents and calling Stripe API for refund.\n";
         stripeApi->issueRefund(transactionId, amountInCents);
     }
+
+    /**
+     * @brief Converts the whole batch to cents in one pass and sends it
+     * to Stripe as a single request.
+     */
+    void payBatch(const vector<double>& amounts) override {
+        ConsoleLine() << "StripeAdapter: Converting " << amounts.size() << " amounts to cents and calling Stripe batch API.\n";
+        stripeApi->chargeBatch(cardDetails, toCents(amounts));
+    }
+
+    void refundBatch(const vector<double>& amounts) override {
+        ConsoleLine() << "StripeAdapter: Converting " << amounts.size() << " amounts to cents and calling Stripe batch API for refund.\n";
+        stripeApi->issueRefundBatch(transactionId, toCents(amounts));
+    }
 };
 
 class PayPalAdapter : public IPaymentGateway {
@@ -108,7 +385,7 @@ public:
      * No amount conversion is needed here.
      */
     void pay(double amount) override {
-        cout << "PayPalAdapter: Calling PayPal API directly." << endl;
+        ConsoleLine() << "PayPalAdapter: Calling PayPal API directly.\n";
         payPalApi->sendPayment(email, amount);
     }
 
@@ -116,20 +393,306 @@ public:
      * @brief Translates the standard 'refund' call into PayPal's 'reversePayment' call.
      */
     void refund(double amount) override {
-        cout << "PayPalAdapter: Calling PayPal API for refund." << endl;
+        ConsoleLine() << "PayPalAdapter: Calling PayPal API for refund.\n";
         payPalApi->reversePayment(paymentId, amount);
     }
+
+    /**
+     * @brief PayPal already works in dollars, so the batch is passed through as is.
+     */
+    void payBatch(const vector<double>& amounts) override {
+        ConsoleLine() << "PayPalAdapter: Calling PayPal batch API directly.\n";
+        payPalApi->sendPaymentBatch(email, amounts);
+    }
+
+    void refundBatch(const vector<double>& amounts) override {
+        ConsoleLine() << "PayPalAdapter: Calling PayPal batch API for refund.\n";
+        payPalApi->reversePaymentBatch(paymentId, amounts);
+    }
 };
 
 
+// Connection pool
+// A single adapter talks to its provider one call at a time. The pool keeps
+// several adapters ("connections"), each with its own worker thread and queue
+// of pending calls, so many payments can be in flight at once.
+// Callers get a future back and only wait when they need the result.
+
+class PaymentGatewayPool {
+private:
+    struct Connection {
+        unique_ptr<IPaymentGateway> gateway;
+        queue<packaged_task<void()>> pending;
+        mutex lock;
+        condition_variable ready;
+        bool closing = false;
+        thread worker;
+    };
+
+    vector<unique_ptr<Connection>> connections;
+    atomic<size_t> nextConnection{0};
+
+    static void serve(Connection* connection) {
+        while (true) {
+            packaged_task<void()> call;
+            {
+                unique_lock<mutex> guard(connection->lock);
+                connection->ready.wait(guard, [connection] {
+                    return connection->closing || !connection->pending.empty();
+                });
+                if (connection->pending.empty()) return; // closing and drained
+                call = move(connection->pending.front());
+                connection->pending.pop();
+            }
+            call();
+        }
+    }
+
+    // Round-robin over the connections and queue the call on the chosen one.
+    future<void> submit(function<void(IPaymentGateway&)> call) {
+        if (connections.empty()) {
+            throw logic_error("PaymentGatewayPool: add a connection before submitting calls");
+        }
+        Connection& connection = *connections[nextConnection++ % connections.size()];
+        IPaymentGateway& gateway = *connection.gateway;
+        packaged_task<void()> task([call, &gateway] { call(gateway); });
+        future<void> result = task.get_future();
+        {
+            lock_guard<mutex> guard(connection.lock);
+            connection.pending.push(move(task));
+        }
+        connection.ready.notify_one();
+        return result;
+    }
+
+public:
+    PaymentGatewayPool() = default;
+    PaymentGatewayPool(const PaymentGatewayPool&) = delete;
+    PaymentGatewayPool& operator=(const PaymentGatewayPool&) = delete;
+
+    ~PaymentGatewayPool() {
+        for (auto& connection : connections) {
+            {
+                lock_guard<mutex> guard(connection->lock);
+                connection->closing = true;
+            }
+            connection->ready.notify_one();
+        }
+        for (auto& connection : connections) {
+            connection->worker.join();
+        }
+    }
+
+    // Connections must all be added before the first call is submitted.
+    void addConnection(unique_ptr<IPaymentGateway> gateway) {
+        auto connection = make_unique<Connection>();
+        connection->gateway = move(gateway);
+        connection->worker = thread(serve, connection.get());
+        connections.push_back(move(connection));
+    }
+
+    future<void> payAsync(double amount) {
+        return submit([amount](IPaymentGateway& gateway) { gateway.pay(amount); });
+    }
+
+    future<void> refundAsync(double amount) {
+        return submit([amount](IPaymentGateway& gateway) { gateway.refund(amount); });
+    }
+};
+
+// Idempotent retries
+// When a call times out the client retries it, and the provider may end up
+// charging twice. Every call here carries an idempotency key: a key that
+// already went through is skipped, a key that is still going through makes
+// the duplicate wait for the outcome, and a failing call is retried with a
+// growing, jittered delay so many clients don't all retry at the same moment.
+
+// Remembers the most recent keys. The keys are split across stripes, each with
+// its own lock, so calls with different keys rarely wait on each other.
+class IdempotencyCache {
+private:
+    static constexpr size_t kStripes = 16;
+
+    enum class State { InProgress, Done };
+
+    struct Stripe {
+        mutex lock;
+        condition_variable changed;
+        unordered_map<string, State> keys;
+        deque<string> done; // finished keys, oldest first, used to stay within capacity
+    };
+
+    array<Stripe, kStripes> stripes;
+    size_t capacityPerStripe;
+
+    Stripe& stripeFor(const string& key) {
+        return stripes[hash<string>{}(key) % kStripes];
+    }
+
+public:
+    explicit IdempotencyCache(size_t capacity)
+        : capacityPerStripe(max<size_t>(1, capacity / kStripes)) {}
+
+    /**
+     * @brief Returns true when the caller should make the call, false when it already went through.
+     * If another caller is still making the call for this key, waits for it to
+     * finish first. Should that call fail, this caller gets to try instead.
+     */
+    bool claim(const string& key) {
+        Stripe& stripe = stripeFor(key);
+        unique_lock<mutex> guard(stripe.lock);
+        while (true) {
+            auto [it, inserted] = stripe.keys.try_emplace(key, State::InProgress);
+            if (inserted) return true;
+            if (it->second == State::Done) return false;
+            stripe.changed.wait(guard);
+        }
+    }
+
+    /**
+     * @brief Marks a claimed key as gone through, and wakes up anyone waiting on it.
+     */
+    void finish(const string& key) {
+        Stripe& stripe = stripeFor(key);
+        {
+            lock_guard<mutex> guard(stripe.lock);
+            stripe.keys[key] = State::Done;
+            stripe.done.push_back(key);
+            if (stripe.done.size() > capacityPerStripe) {
+                stripe.keys.erase(stripe.done.front());
+                stripe.done.pop_front();
+            }
+        }
+        stripe.changed.notify_all();
+    }
+
+    /**
+     * @brief Forgets a claimed key whose call failed for good, so it can be tried again.
+     */
+    void release(const string& key) {
+        Stripe& stripe = stripeFor(key);
+        {
+            lock_guard<mutex> guard(stripe.lock);
+            stripe.keys.erase(key);
+        }
+        stripe.changed.notify_all();
+    }
+};
+
+// Sits in front of any IPaymentGateway. Providers report a failed call by
+// throwing runtime_error.
+class IdempotentPaymentGateway {
+private:
+    IPaymentGateway* gateway;
+    IdempotencyCache cache;
+    int maxAttempts;
+    chrono::milliseconds baseDelay;
+
+    void backoff(int attempt) {
+        thread_local mt19937 rng(random_device{}());
+        long long cap = baseDelay.count() << attempt; // 1x, 2x, 4x, ...
+        uniform_int_distribution<long long> jitter(cap / 2, cap);
+        this_thread::sleep_for(chrono::milliseconds(jitter(rng)));
+    }
+
+    // Gives a claimed key back unless the call went through, whatever way
+    // callOnce() is left. A key left in progress would make every later call
+    // for it wait forever.
+    struct ClaimGuard {
+        IdempotencyCache& cache;
+        const string& key;
+        bool finished = false;
+
+        ~ClaimGuard() {
+            if (!finished) cache.release(key);
+        }
+    };
+
+    void callOnce(const string& key, const function<void()>& call) {
+        if (!cache.claim(key)) {
+            ConsoleLine() << "IdempotentGateway: '" << key << "' already handled, skipping.\n";
+            return;
+        }
+        ClaimGuard claim{cache, key};
+        // Only provider failures (runtime_error) are retried, anything else
+        // goes straight back to the caller
+        for (int attempt = 0;; ++attempt) {
+            try {
+                call();
+                break;
+            } catch (const runtime_error& error) {
+                if (attempt + 1 == maxAttempts) throw;
+                ConsoleLine() << "IdempotentGateway: '" << key << "' failed (" << error.what()
+                              << "), retrying.\n";
+            }
+            backoff(attempt);
+        }
+        cache.finish(key);
+        claim.finished = true;
+    }
+
+public:
+    IdempotentPaymentGateway(IPaymentGateway* target, size_t cacheCapacity = 4096,
+                             int attempts = 3,
+                             chrono::milliseconds delay = chrono::milliseconds(10))
+        : gateway(target), cache(cacheCapacity), maxAttempts(attempts), baseDelay(delay) {
+        if (attempts <= 0) throw invalid_argument("IdempotentPaymentGateway: attempts must be at least 1");
+    }
+
+    // The operation is part of the key: refunding "order-1001" is not a
+    // duplicate of paying "order-1001".
+    void pay(const string& key, double amount) {
+        callOnce("pay:" + key, [this, amount] { gateway->pay(amount); });
+    }
+
+    void refund(const string& key, double amount) {
+        callOnce("refund:" + key, [this, amount] { gateway->refund(amount); });
+    }
+};
+
+// A local fake provider that fails the first few calls, to exercise the retries.
+class FlakyGateway : public IPaymentGateway {
+private:
+    IPaymentGateway* gateway;
+    int failuresLeft;
+
+public:
+    FlakyGateway(IPaymentGateway* target, int failures)
+        : gateway(target), failuresLeft(failures) {}
+
+    void pay(double amount) override {
+        if (failuresLeft > 0) {
+            --failuresLeft;
+            throw runtime_error("timeout");
+        }
+        gateway->pay(amount);
+    }
+
+    void refund(double amount) override {
+        if (failuresLeft > 0) {
+            --failuresLeft;
+            throw runtime_error("timeout");
+        }
+        gateway->refund(amount);
+    }
+};
+
 // Client Code
 // The client code interacts with any object that follows the IPaymentGateway interface.
 // It doesn't need to know the specifics of Stripe or PayPal.
 
 void processOrder(IPaymentGateway* gateway, double totalAmount) {
-    cout << "\n--- Processing an order of $" << fixed << setprecision(2) << totalAmount << " ---" << endl;
+    cout << "\n--- Processing an order of $" << fixed << setprecision(2) << totalAmount << " ---\n";
     gateway->pay(totalAmount);
-    cout << "--- Order processed successfully! ---" << endl;
+    cout << "--- Order processed successfully! ---\n";
+}
+
+// Same idea for a whole cart of orders: one call, and the adapter decides
+// whether its provider can take them all at once.
+void processOrders(IPaymentGateway* gateway, const vector<double>& amounts) {
+    cout << "\n--- Processing " << amounts.size() << " orders ---\n";
+    gateway->payBatch(amounts);
+    cout << "--- Orders processed successfully! ---\n";
 }
 
 int main() {
@@ -148,8 +711,62 @@ int main() {
     processOrder(&paypalGateway, 89.99);
 
     // We can also issue a refund using the same adapters
-    cout << "\n--- Issuing a refund ---" << endl;
+    cout << "\n--- Issuing a refund ---\n";
     stripeGateway.refund(25.00);
 
+    // Batches go through the same interface
+    processOrders(&stripeGateway, {10.00, 20.50, 5.25});
+    processOrders(&paypalGateway, {12.00, 7.99});
+
+    // Async calls through a pool of two Stripe connections.
+    // The order of the output depends on which connection finishes first.
+    cout << "\n--- Processing orders through a connection pool ---\n";
+    {
+        PaymentGatewayPool pool;
+        pool.addConnection(make_unique<StripeAdapter>(&stripeService, "1234-5678-9012-3456", "txn_stripe123"));
+        pool.addConnection(make_unique<StripeAdapter>(&stripeService, "1234-5678-9012-3456", "txn_stripe124"));
+
+        vector<future<void>> inFlight;
+        for (double amount : {30.00, 40.00, 50.00, 60.00}) {
+            inFlight.push_back(pool.payAsync(amount));
+        }
+        for (auto& payment : inFlight) {
+            payment.get();
+        }
+    }
+    cout << "--- All pooled orders completed! ---\n";
+
+    // A retried charge and a duplicate refund, both with idempotency keys
+    cout << "\n--- Processing orders with idempotency keys ---\n";
+    FlakyGateway flakyStripe(&stripeGateway, 1); // first call times out
+    IdempotentPaymentGateway safeGateway(&flakyStripe);
+    safeGateway.pay("order-1001", 99.99);
+    safeGateway.pay("order-1001", 99.99); // client retried, must not charge twice
+    safeGateway.refund("order-1001", 99.99);
+    safeGateway.refund("order-1001", 99.99);
+
+    // The client retries while the first call is still retrying: the
+    // duplicate waits for the outcome instead of being told it went through.
+    cout << "\n--- Retrying while the first call is still going ---\n";
+    FlakyGateway flakyAgain(&stripeGateway, 1);
+    IdempotentPaymentGateway racingGateway(&flakyAgain);
+    thread firstTry([&] { racingGateway.pay("order-1002", 45.00); });
+    thread secondTry([&] { racingGateway.pay("order-1002", 45.00); });
+    firstTry.join();
+    secondTry.join();
+
+    // The same calls with their lines going through the async log: the
+    // paying thread only copies each line into its buffer, and the log's
+    // own thread writes them to cout.
+    cout << "\n--- Logging through the async log ---\n";
+    {
+        AsyncLog log(cout);
+        ConsoleLine::sendTo(&log);
+        stripeGateway.payBatch({15.00, 25.00});
+        stripeGateway.refund(15.00);
+        ConsoleLine::sendTo(nullptr);
+    } // the log writes out what is left before it goes away
+    cout << "--- Async log closed ---\n";
+
     return 0;
 }
@@ -9,7 +9,7 @@ public:
     void charge(const std::string& cardDetails, int amountCents) {
         std::cout << "Stripe: Charging card '" << cardDetails << "' for "
              << std::fixed << std::setprecision(2) << static_cast<double>(amountCents) / 100.0
-             << " USD." << std::endl;
+             << " USD.\n";
     }
 };
 
@@ -18,7 +18,7 @@ public:
     void sendPayment(const std::string& email, double amountDollars) {
         std::cout << "PayPal: Sending payment of "
              << std::fixed << std::setprecision(2) << amountDollars
-             << " USD to '" << email << "'." << std::endl;
+             << " USD to '" << email << "'.\n";
     }
 };
 
@@ -27,7 +27,7 @@ public:
 // It must contain logic to handle each one individually.
 
 void processOrder(const std::string& gatewayType, double totalAmount) {
-    std::cout << "\n--- Processing an order of $" << std::fixed << std::setprecision(2) << totalAmount << " ---" << std::endl;
+    std::cout << "\n--- Processing an order of $" << std::fixed << std::setprecision(2) << totalAmount << " ---\n";
 
     if (gatewayType == "stripe") {
         // Specific logic for Stripe
@@ -35,7 +35,7 @@ void processOrder(const std::string& gatewayType, double totalAmount) {
         std::string cardDetails = "1234-5678-9012-3456"; // Hardcoded for example
         int amountInCents = static_cast<int>(totalAmount * 100); // In-place data conversion
         
-        std::cout << "Client: Handling Stripe payment directly. Converting to cents." << std::endl;
+        std::cout << "Client: Handling Stripe payment directly. Converting to cents.\n";
         stripeService.charge(cardDetails, amountInCents);
 
     } else if (gatewayType == "paypal") {
@@ -43,13 +43,13 @@ void processOrder(const std::string& gatewayType, double totalAmount) {
         PayPalAPI paypalService;
         std::string email = "customer@example.com"; // Hardcoded for example
 
-        std::cout << "Client: Handling PayPal payment directly." << std::endl;
+        std::cout << "Client: Handling PayPal payment directly.\n";
         paypalService.sendPayment(email, totalAmount);
 
     } else {
-        std::cout << "Error: Unknown payment gateway type '" << gatewayType << "'." << std::endl;
+        std::cout << "Error: Unknown payment gateway type '" << gatewayType << "'.\n";
     }
-     std::cout << "--- Order processed! ---" << std::endl;
+     std::cout << "--- Order processed! ---\n";
 }
 
 int main() {
@@ -62,7 +62,7 @@ int main() {
     // What if we want to add a new payment provider called "Square"?
     // We would have to go back and add another 'else if' block to the processOrder function.
     // This is not scalable and violates the Open/Closed Principle.
-    std::cout << "\n--- Trying to process with a new, unsupported gateway ---" << std::endl;
+    std::cout << "\n--- Trying to process with a new, unsupported gateway ---\n";
     processOrder("square", 49.95);
 
     return 0;
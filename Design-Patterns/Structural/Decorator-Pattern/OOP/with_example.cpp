@@ -3,11 +3,15 @@
 #include <memory>
 #include <vector>
 #include <algorithm> // For std::find
+#include <memory_resource> // For the per-request arena
+#include <thread>
+#include <atomic>
 
 using namespace std;
 // For simplicity, we'll represent our JSON as a string.
 // In a real app, you'd use a proper JSON library.
-using JsonString = string;
+// It is a pmr::string so its characters can live in the request's arena too.
+using JsonString = pmr::string;
 
 // A more robust way to handle user context instead of booleans
 enum class UserRole {
@@ -26,28 +30,50 @@ public:
 
 // 2. A Concrete Component
 // This is the base response. It fetches and formats the core data.
+// The JSON string is created in `arena`; the decorators append to that same
+// string, so the whole response text stays in the arena.
 class BlogPostResponse : public ApiResponse {
 private:
     int postId;
+    pmr::memory_resource* arena;
 public:
-    explicit BlogPostResponse(int id) : postId(id) {}
+    BlogPostResponse(int id, pmr::memory_resource& resource) : postId(id), arena(&resource) {}
 
     JsonString generate() const override {
         // In a real app, this would fetch data from a database.
         // For example: SELECT title, content FROM posts WHERE id = postId;
-        return "{\n  \"postId\": " + to_string(postId) + ",\n" +
-               "  \"title\": \"Decorator Pattern in the Real World\",\n" +
-               "  \"content\": \"This pattern is great for...\"\n}";
+        JsonString json(arena);
+        json.reserve(512); // room for every decorator, so the string never moves
+        json += "{\n  \"postId\": ";
+        json += to_string(postId);
+        json += ",\n  \"title\": \"Decorator Pattern in the Real World\",\n"
+                "  \"content\": \"This pattern is great for...\"\n}";
+        return json;
     }
 };
 
+// Each request builds its own chain of response objects. Instead of asking the
+// heap for every layer, we carve them out of a per-request arena and drop the
+// whole arena in one step when the request is done.
+// The deleter only runs the destructor, the arena owns the memory.
+struct ArenaDelete {
+    void operator()(ApiResponse* response) const { response->~ApiResponse(); }
+};
+using ResponsePtr = unique_ptr<ApiResponse, ArenaDelete>;
+
+template <typename T, typename... Args>
+ResponsePtr makeInArena(pmr::memory_resource& arena, Args&&... args) {
+    void* memory = arena.allocate(sizeof(T), alignof(T));
+    return ResponsePtr(new (memory) T(std::forward<Args>(args)...));
+}
+
 // 3. The Decorator Base Class
 // It holds a reference to the response it will decorate.
 class ResponseDecorator : public ApiResponse {
 protected:
-    unique_ptr<ApiResponse> wrappedResponse;
+    ResponsePtr wrappedResponse;
 public:
-    ResponseDecorator(unique_ptr<ApiResponse> response) : wrappedResponse(move(response)) {}
+    ResponseDecorator(ResponsePtr response) : wrappedResponse(move(response)) {}
 
     JsonString generate() const override {
         return wrappedResponse->generate();
@@ -60,7 +86,7 @@ public:
 // Adds view statistics for the post's author.
 class AuthorStatsDecorator : public ResponseDecorator {
 public:
-    AuthorStatsDecorator(unique_ptr<ApiResponse> response) : ResponseDecorator(move(response)) {}
+    AuthorStatsDecorator(ResponsePtr response) : ResponseDecorator(move(response)) {}
 
     JsonString generate() const override {
         JsonString baseJson = wrappedResponse->generate();
@@ -68,73 +94,112 @@ public:
         baseJson.pop_back(); 
         
         // In a real app, this would fetch stats from a different service or table.
-        string statsData = ",\n  \"stats\": {\n"
-                            "    \"views\": 1024,\n"
-                            "    \"comments\": 25\n"
-                            "  }\n}";
-        return baseJson + statsData;
+        // Appending in place avoids building a second temporary string.
+        baseJson += ",\n  \"stats\": {\n"
+                    "    \"views\": 1024,\n"
+                    "    \"comments\": 25\n"
+                    "  }\n}";
+        return baseJson;
     }
 };
 
 // Adds moderation info for an editor.
 class EditorModerationDecorator : public ResponseDecorator {
 public:
-    EditorModerationDecorator(unique_ptr<ApiResponse> response) : ResponseDecorator(move(response)) {}
+    EditorModerationDecorator(ResponsePtr response) : ResponseDecorator(move(response)) {}
 
     JsonString generate() const override {
         JsonString baseJson = wrappedResponse->generate();
         baseJson.pop_back();
 
-        string moderationData = ",\n  \"moderation\": {\n"
-                                     "    \"status\": \"published\",\n"
-                                     "    \"lastEditedBy\": \"editor01\"\n"
-                                     "  }\n}";
-        return baseJson + moderationData;
+        baseJson += ",\n  \"moderation\": {\n"
+                    "    \"status\": \"published\",\n"
+                    "    \"lastEditedBy\": \"editor01\"\n"
+                    "  }\n}";
+        return baseJson;
     }
 };
 
 // Adds debug/profiling info for a developer.
 class DebugProfilingDecorator : public ResponseDecorator {
 public:
-    DebugProfilingDecorator(unique_ptr<ApiResponse> response) : ResponseDecorator(move(response)) {}
+    DebugProfilingDecorator(ResponsePtr response) : ResponseDecorator(move(response)) {}
 
     JsonString generate() const override {
         JsonString baseJson = wrappedResponse->generate();
         baseJson.pop_back();
 
-        string profilingData = ",\n  \"_debug\": {\n"
-                                    "    \"dbQueryMs\": 45,\n"
-                                    "    \"cacheHit\": false,\n"
-                                    "    \"serverNode\": \"prod-us-east-5a\"\n"
-                                    "  }\n}";
-        return baseJson + profilingData;
+        baseJson += ",\n  \"_debug\": {\n"
+                    "    \"dbQueryMs\": 45,\n"
+                    "    \"cacheHit\": false,\n"
+                    "    \"serverNode\": \"prod-us-east-5a\"\n"
+                    "  }\n}";
+        return baseJson;
     }
 };
 
-// --- Web Server Request Handler Simulation ---
-// Refactored to accept a vector of roles instead of multiple booleans.
-void handleApiRequest(const vector<UserRole>& roles) {
-    cout << "--- New Request ---" << endl;
-    cout << "Context: Request with " << roles.size() << " special role(s)." << endl;
+// Big enough for the whole decorator chain plus the JSON text. If a request
+// ever needs more, the arena quietly falls back to the heap.
+constexpr size_t kArenaBytes = 2048;
 
+// Builds the response object for the given roles inside `arena`.
+ResponsePtr buildResponse(const vector<UserRole>& roles, pmr::memory_resource& arena) {
     // Start with the basic blog post response
-    unique_ptr<ApiResponse> response = make_unique<BlogPostResponse>(101);
+    ResponsePtr response = makeInArena<BlogPostResponse>(arena, 101, arena);
 
     // Conditionally wrap the response with decorators by checking the roles vector
     if (find(roles.begin(), roles.end(), UserRole::AUTHOR) != roles.end()) {
-        response = make_unique<AuthorStatsDecorator>(move(response));
+        response = makeInArena<AuthorStatsDecorator>(arena, move(response));
     }
     if (find(roles.begin(), roles.end(), UserRole::EDITOR) != roles.end()) {
-        response = make_unique<EditorModerationDecorator>(move(response));
+        response = makeInArena<EditorModerationDecorator>(arena, move(response));
     }
     if (find(roles.begin(), roles.end(), UserRole::DEBUGGER) != roles.end()) {
-        response = make_unique<DebugProfilingDecorator>(move(response));
+        response = makeInArena<DebugProfilingDecorator>(arena, move(response));
     }
+    return response;
+}
+
+// --- Web Server Request Handler Simulation ---
+// Refactored to accept a vector of roles instead of multiple booleans.
+void handleApiRequest(const vector<UserRole>& roles) {
+    cout << "--- New Request ---" << endl;
+    cout << "Context: Request with " << roles.size() << " special role(s)." << endl;
+
+    // The arena lives for exactly one request. It is declared before the
+    // response so it outlives every object allocated from it.
+    alignas(max_align_t) byte buffer[kArenaBytes];
+    pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
 
+    ResponsePtr response = buildResponse(roles, arena);
     cout << "\nFinal JSON Response:\n" << response->generate() << endl;
     cout << "---------------------\n\n";
 }
 
+// Serves many requests on several threads, like a real server would.
+// Each thread takes the next request and gives it a fresh arena on its own
+// stack, so the threads never share an allocator. Returns the total size of
+// all responses.
+size_t serveRequests(const vector<vector<UserRole>>& requests, unsigned threadCount) {
+    atomic<size_t> next{0};
+    atomic<size_t> totalBytes{0};
+    vector<thread> threads;
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&] {
+            size_t bytes = 0;
+            for (size_t i = next++; i < requests.size(); i = next++) {
+                alignas(max_align_t) byte buffer[kArenaBytes];
+                pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+                ResponsePtr response = buildResponse(requests[i], arena);
+                bytes += response->generate().size();
+            }
+            totalBytes += bytes;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return totalBytes;
+}
+
 int main() {
     // Simulate a request from a regular user (no special roles)
     handleApiRequest({});
@@ -148,6 +213,15 @@ int main() {
     // Simulate a request from a developer debugging an editor's view
     handleApiRequest({UserRole::EDITOR, UserRole::DEBUGGER});
 
+    // A busy server: the same kinds of requests, many times, on 4 threads
+    vector<vector<UserRole>> requests;
+    for (int i = 0; i < 1000; ++i) {
+        requests.push_back({});
+        requests.push_back({UserRole::AUTHOR, UserRole::EDITOR, UserRole::DEBUGGER});
+    }
+    size_t bytes = serveRequests(requests, 4);
+    cout << "Served " << requests.size() << " requests on 4 threads (" << bytes << " bytes of JSON)\n";
+
     return 0;
 }
 
@@ -1,34 +1,146 @@
 #include <iostream>
 #include <string>
 #include <cmath> 
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <atomic>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <cstdint>
+#include <type_traits>
+#include <fstream>
+#include <array>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <memory>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 // Subsystem Part 1: Inventory System
+// Keeps one pair of counters per product. A successful stock check reserves
+// the items right away, so two orders can never both get the last item.
+// The reservation is later committed (order done) or released (order failed).
 class InventorySystem {
+private:
+    struct StockLevel {
+        atomic<int> available;
+        atomic<int> reserved{0};
+        explicit StockLevel(int quantity) : available(quantity) {}
+    };
+
+    // Products are added before orders start coming in. After that the map
+    // itself never changes, only the atomic counters inside it, so orders for
+    // different products never wait on each other.
+    unordered_map<string, StockLevel> stock;
+
 public:
+    void addStock(const string& productId, int quantity) {
+        auto [it, inserted] = stock.try_emplace(productId, quantity);
+        if (!inserted) it->second.available += quantity;
+    }
+
     bool checkStock(const string& productId, int quantity) {
-        cout << "Checking stock for " << productId << "..." << endl;
-        // Simulate a real stock check
-        if (quantity < 100) {
-            cout << "Stock is available." << endl;
-            return true;
+        cout << "Checking stock for " << productId << "...\n";
+        if (quantity <= 0) {
+            cout << "Invalid quantity " << quantity << ".\n";
+            return false;
         }
-        cout << "Stock is NOT available." << endl;
+        auto it = stock.find(productId);
+        if (it != stock.end()) {
+            StockLevel& level = it->second;
+            // Take the items only if enough are still there. If another order
+            // changed the count in between, reload it and try again.
+            int current = level.available.load();
+            while (current >= quantity) {
+                if (level.available.compare_exchange_weak(current, current - quantity)) {
+                    level.reserved += quantity;
+                    cout << "Stock is available (reserved " << quantity << ").\n";
+                    return true;
+                }
+            }
+        }
+        cout << "Stock is NOT available.\n";
         return false;
     }
+
+    // Several orders for one product, in the order they were placed. Each order
+    // gets its items if they still fit, just as if the orders had come in one
+    // by one, but everything that fits is reserved with a single update.
+    vector<bool> checkStock(const string& productId, const vector<int>& quantities) {
+        cout << "Checking stock for " << quantities.size() << " orders of " << productId << "...\n";
+        vector<bool> fits(quantities.size(), false);
+        auto it = stock.find(productId);
+        if (it == stock.end()) {
+            cout << "Stock is NOT available.\n";
+            return fits;
+        }
+        StockLevel& level = it->second;
+        int current = level.available.load();
+        int taken;
+        do {
+            taken = 0;
+            for (size_t i = 0; i < quantities.size(); ++i) {
+                fits[i] = quantities[i] > 0 && quantities[i] <= current - taken;
+                if (fits[i]) taken += quantities[i];
+            }
+        } while (taken > 0 && !level.available.compare_exchange_weak(current, current - taken));
+        level.reserved += taken;
+        cout << "Reserved " << taken << " " << productId << " for "
+             << count(fits.begin(), fits.end(), true) << " of the orders.\n";
+        return fits;
+    }
+
+    // The order went through, the reserved items are gone for good.
+    void commitStock(const string& productId, int quantity) {
+        stock.at(productId).reserved -= quantity;
+    }
+
+    // The order failed, put the reserved items back on the shelf.
+    void releaseStock(const string& productId, int quantity) {
+        StockLevel& level = stock.at(productId);
+        level.reserved -= quantity;
+        level.available += quantity;
+        cout << "Released " << quantity << " " << productId << " back to stock.\n";
+    }
+
+    // Reserved items belong to orders that are still going through.
+    void printStock() const {
+        map<string, const StockLevel*> sorted;
+        for (const auto& [productId, level] : stock) sorted[productId] = &level;
+        for (const auto& [productId, level] : sorted) {
+            cout << "  " << productId << ": " << level->available << " available, "
+                 << level->reserved << " reserved\n";
+        }
+    }
 };
 
 // Subsystem Part 2: Payment Gateway
 class PaymentGateway {
 public:
     bool processPayment(const string& creditCard, double amount) {
-        cout << "Processing payment of $" << amount << "..." << endl;
+        cout << "Processing payment of $" << amount << "...\n";
         if (creditCard == "1") { //for example, "1" is a valid card
-            cout << "Payment successful !" << endl;
+            cout << "Payment successful !\n";
             return true;
         }
-        cout << "Payment failed (invalid card)." << endl;
+        cout << "Payment failed (invalid card).\n";
         return false;
     }
 };
@@ -37,11 +149,470 @@ public:
 class ShippingService {
 public:
     void createShipment(const string& productId, const string& address) {
-        cout << "Creating shipment for " << productId << " to " << address << endl;
-        cout << "Shipment created !." << endl;
+        cout << "Creating shipment for " << productId << " to " << address << '\n';
+        cout << "Shipment created !.\n";
+    }
+
+    // One parcel for several products going to the same address
+    void createShipment(const vector<string>& productIds, const string& address) {
+        cout << "Creating one shipment for " << productIds.size() << " products to " << address << "\n";
+        cout << "Shipment created !.\n";
     }
 };
 
+// Subsystem Part 4: Order Log
+// An append-only file of order state changes, one "<orderId> <STATE>" line
+// each. A step is only acted on once its line is on the disk, so after a
+// crash we can still tell which orders were paid but never shipped.
+// Records from all threads are collected in memory, and one commit() writes
+// and syncs every record collected so far in one go (group commit). With
+// group commit off every record is written and synced on its own.
+// A log made without a path keeps nothing: record() and commit() do nothing,
+// only the order IDs are handed out.
+
+// Pushes what was written to `file` past the OS cache, onto the disk.
+static bool syncToDisk(FILE* file) {
+    if (fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(file)) == 0;
+#else
+    return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+// Makes a rename inside `path`'s directory survive a crash: the new name is
+// only safe once the directory itself is synced. Windows has no equivalent.
+static bool syncDirectoryOf(const string& path) {
+#if defined(_WIN32)
+    (void)path;
+    return true;
+#else
+    string directory = filesystem::path(path).parent_path().string();
+    int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+class OrderLog {
+private:
+    FILE* file = nullptr; // none when the log is off
+    bool groupCommit;
+    string pending; // records not written yet
+    mutex pendingLock;
+    mutex fileLock;
+    atomic<uint64_t> nextOrderId{1};
+    vector<uint64_t> unfinished;
+
+    // Reads the log left by earlier runs: order IDs continue after the last
+    // one used, and orders whose last state is PAID are reported.
+    // Returns the last state of every order found.
+    map<uint64_t, string> recover(const string& path) {
+        ifstream in(path);
+        map<uint64_t, string> lastState;
+        string line;
+        while (getline(in, line)) {
+            // A last line without its '\n' was cut off by a crash mid-write
+            if (in.eof()) break;
+            istringstream fields(line);
+            uint64_t orderId;
+            string state;
+            if (!(fields >> orderId >> state)) continue;
+            if (state != "PAID" && state != "SHIPPED" && state != "FAILED") continue;
+            lastState[orderId] = state;
+            if (orderId >= nextOrderId) nextOrderId = orderId + 1;
+        }
+        for (const auto& [id, last] : lastState) {
+            if (last == "PAID") unfinished.push_back(id);
+        }
+        return lastState;
+    }
+
+    // Finished orders don't need their lines any more. Rewrites the log with
+    // only the unfinished orders, plus the newest order so the IDs keep
+    // counting up. The new log is synced before it replaces the old one.
+    void compact(const string& path, const map<uint64_t, string>& lastState) {
+        string kept;
+        for (uint64_t orderId : unfinished) kept += to_string(orderId) + " PAID\n";
+        if (!lastState.empty()) {
+            const auto& [newestId, newestState] = *lastState.rbegin();
+            if (newestState != "PAID") kept += to_string(newestId) + " " + newestState + "\n";
+        }
+
+        string tempPath = path + ".tmp";
+        FILE* temp = fopen(tempPath.c_str(), "wb");
+        if (!temp) throw runtime_error("OrderLog: cannot create " + tempPath);
+        bool written = fwrite(kept.data(), 1, kept.size(), temp) == kept.size() && syncToDisk(temp);
+        fclose(temp);
+        if (!written) throw runtime_error("OrderLog: cannot write " + tempPath);
+        filesystem::rename(tempPath, path);
+        if (!syncDirectoryOf(path)) throw runtime_error("OrderLog: cannot sync the directory of " + path);
+    }
+
+    // Caller holds fileLock
+    void writeAndSync(const string& records) {
+        if (fwrite(records.data(), 1, records.size(), file) != records.size() || !syncToDisk(file)) {
+            throw runtime_error("OrderLog: writing the log failed");
+        }
+    }
+
+public:
+    explicit OrderLog(const string& path = "", bool groupCommit = true) : groupCommit(groupCommit) {
+        if (path.empty()) return;
+        compact(path, recover(path));
+        file = fopen(path.c_str(), "ab");
+        if (!file) throw runtime_error("OrderLog: cannot open " + path);
+    }
+
+    OrderLog(const OrderLog&) = delete;
+    OrderLog& operator=(const OrderLog&) = delete;
+
+    // Records nobody committed yet still make it to the disk.
+    ~OrderLog() {
+        try {
+            commit();
+        } catch (const exception& error) {
+            cerr << error.what() << "\n";
+        }
+        if (file) fclose(file);
+    }
+
+    uint64_t newOrderId() {
+        return nextOrderId++;
+    }
+
+    void record(uint64_t orderId, const char* state) {
+        if (!file) return;
+        string line = to_string(orderId) + ' ' + state + '\n';
+        if (!groupCommit) {
+            lock_guard<mutex> writer(fileLock);
+            writeAndSync(line);
+            return;
+        }
+        lock_guard<mutex> guard(pendingLock);
+        pending += line;
+    }
+
+    // If another thread's commit already wrote our records, there is nothing
+    // left to do: they were synced before that thread released fileLock.
+    void commit() {
+        if (!file) return;
+        lock_guard<mutex> writer(fileLock);
+        string batch;
+        {
+            lock_guard<mutex> guard(pendingLock);
+            batch.swap(pending);
+        }
+        if (batch.empty()) return;
+        writeAndSync(batch);
+    }
+
+    const vector<uint64_t>& unfinishedOrders() const {
+        return unfinished;
+    }
+};
+
+// Latency histogram
+// Counts how long calls take. Each power of two (4-7ns, 8-15ns, 16-31ns ...)
+// is split into kSubBuckets equal buckets, so a percentile is read back
+// within 1/kSubBuckets of the real value instead of within a factor of two.
+// Percentiles are read back as the first value above the bucket.
+// Every thread records into a shard of its own with plain increments, so
+// timing a call costs a few nanoseconds and threads never share a cache line.
+// The shards are only added up when a report asks for the numbers.
+class LatencyHistogram {
+private:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    // Values below kSubBuckets get a bucket each, then kSubBuckets buckets
+    // for every power of two up to 2^63.
+    static constexpr int kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    // Only its own thread writes to a shard, so the counters need no atomic
+    // add. They are atomics anyway so summary() can read them while that
+    // thread is still recording; a relaxed load and store is a plain move.
+    struct alignas(64) Shard {
+        array<atomic<uint64_t>, kBuckets> counts{};
+        atomic<uint64_t> samples{0};
+        atomic<uint64_t> totalNanos{0};
+    };
+
+    const uint64_t id; // tells this histogram apart in the threads' caches
+    vector<unique_ptr<Shard>> shards;
+    mutable mutex shardsLock;
+
+    static uint64_t nextId() {
+        static atomic<uint64_t> counter{1};
+        return counter++;
+    }
+
+    // Number of bits needed to write `value`, 0 for 0.
+    static int bitWidth(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long highest;
+        return _BitScanReverse64(&highest, value) ? int(highest) + 1 : 0;
+#else
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#endif
+    }
+
+    static int bucketOf(uint64_t nanos) {
+        if (nanos < uint64_t(kSubBuckets)) return int(nanos);
+        int shift = bitWidth(nanos) - 1 - kSubBucketBits;
+        // The top kSubBucketBits + 1 bits of the value; the leading 1 picks
+        // the power of two, the bits after it the sub-bucket.
+        return (shift + 1) * kSubBuckets + int((nanos >> shift) - kSubBuckets);
+    }
+
+    // The first value that no longer falls into `bucket` (the last bucket
+    // runs to the largest value there is).
+    static uint64_t bucketEnd(int bucket) {
+        if (bucket < kSubBuckets) return uint64_t(bucket) + 1;
+        if (bucket == kBuckets - 1) return UINT64_MAX;
+        int shift = bucket / kSubBuckets - 1;
+        uint64_t first = uint64_t(kSubBuckets + bucket % kSubBuckets) << shift;
+        return first + (uint64_t(1) << shift);
+    }
+
+    // The calling thread's shard. Each thread remembers the last histogram
+    // it recorded into, which is all a ScopedTimer on one step needs; going
+    // back and forth between histograms takes the lock once per switch.
+    Shard& localShard() {
+        struct Cache {
+            uint64_t histogramId = 0;
+            Shard* shard = nullptr;
+        };
+        thread_local Cache cache;
+        if (cache.histogramId == id) return *cache.shard;
+
+        thread_local unordered_map<uint64_t, Shard*> mine;
+        Shard*& shard = mine[id];
+        if (!shard) {
+            lock_guard<mutex> guard(shardsLock);
+            shards.push_back(make_unique<Shard>());
+            shard = shards.back().get();
+        }
+        cache = {id, shard};
+        return *shard;
+    }
+
+    static void increment(atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+public:
+    LatencyHistogram() : id(nextId()) {}
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // The shards added up at one moment.
+    struct Summary {
+        array<uint64_t, kBuckets> counts{};
+        uint64_t samples = 0;
+        uint64_t totalNanos = 0;
+
+        uint64_t meanNanos() const {
+            return samples == 0 ? 0 : totalNanos / samples;
+        }
+
+        // First value above the bucket that holds the given fraction (0..1)
+        // of samples, or 0 when nothing was recorded.
+        uint64_t percentileNanos(double fraction) const {
+            if (samples == 0) return 0;
+            uint64_t target = static_cast<uint64_t>(fraction * samples);
+            uint64_t seen = 0;
+            for (int bucket = 0; bucket < kBuckets; ++bucket) {
+                seen += counts[bucket];
+                if (seen > target) return bucketEnd(bucket);
+            }
+            return bucketEnd(kBuckets - 1);
+        }
+    };
+
+    void record(uint64_t nanos) {
+        Shard& shard = localShard();
+        increment(shard.counts[bucketOf(nanos)], 1);
+        increment(shard.samples, 1);
+        increment(shard.totalNanos, nanos);
+    }
+
+    Summary summary() const {
+        Summary total;
+        lock_guard<mutex> guard(shardsLock);
+        for (const auto& shard : shards) {
+            for (int bucket = 0; bucket < kBuckets; ++bucket) {
+                total.counts[bucket] += shard->counts[bucket].load(memory_order_relaxed);
+            }
+            total.samples += shard->samples.load(memory_order_relaxed);
+            total.totalNanos += shard->totalNanos.load(memory_order_relaxed);
+        }
+        return total;
+    }
+};
+
+// Records the time from construction to destruction into a histogram,
+// or does nothing at all when profiling is off.
+class ScopedTimer {
+private:
+    LatencyHistogram* histogram;
+    chrono::steady_clock::time_point start;
+
+public:
+    ScopedTimer(LatencyHistogram& target, bool enabled)
+        : histogram(enabled ? &target : nullptr) {
+        if (histogram) start = chrono::steady_clock::now();
+    }
+
+    ~ScopedTimer() {
+        if (!histogram) return;
+        auto elapsed = chrono::steady_clock::now() - start;
+        histogram->record(chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+};
+
+// One order inside a batch
+struct OrderRequest {
+    string productId;
+    int quantity;
+    string creditCard;
+    double price;
+    string address;
+};
+
+// Gives every distinct string (a product ID, an address) a small number.
+// The same string gets the same number while it is in use, so an order can
+// carry two 4-byte IDs instead of its own copies of the text.
+// Every intern() must be paired with a release(). Once no order uses a
+// string any more it is dropped and its number reused, so the table only
+// holds the strings of orders that are still going through.
+class InternTable {
+private:
+    struct Entry {
+        uint32_t id;
+        uint32_t users;
+    };
+    unordered_map<string, Entry> ids;
+    vector<const string*> names; // points at the keys in `ids`, which never move
+    vector<uint32_t> freeIds;
+    mutable mutex lock;
+
+public:
+    uint32_t intern(const string& text) {
+        lock_guard<mutex> guard(lock);
+        auto it = ids.find(text);
+        if (it != ids.end()) {
+            ++it->second.users;
+            return it->second.id;
+        }
+        uint32_t id = static_cast<uint32_t>(names.size());
+        if (freeIds.empty()) {
+            names.push_back(nullptr);
+        } else {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        it = ids.emplace(text, Entry{id, 1}).first;
+        names[id] = &it->first;
+        return id;
+    }
+
+    void release(uint32_t id) {
+        lock_guard<mutex> guard(lock);
+        auto it = ids.find(*names[id]);
+        if (--it->second.users > 0) return;
+        ids.erase(it);
+        names[id] = nullptr;
+        freeIds.push_back(id);
+    }
+
+    // The reference stays valid until the matching release().
+    const string& name(uint32_t id) const {
+        lock_guard<mutex> guard(lock);
+        return *names[id];
+    }
+
+    size_t size() const {
+        lock_guard<mutex> guard(lock);
+        return ids.size();
+    }
+};
+
+// The compact form of an order used inside the facade. It is plain data
+// (no strings), so it is cheap to copy into queues and batches.
+// The card number is kept apart: it is sensitive and never repeats enough
+// to be worth interning.
+struct OrderRecord {
+    uint32_t productId;
+    uint32_t addressId;
+    int quantity;
+    double price;
+};
+static_assert(is_trivially_copyable_v<OrderRecord>, "OrderRecord must stay plain data");
+
+// A queue between two pipeline stages. It holds at most `capacity` items:
+// a fast stage blocks on push() instead of piling up work for a slow one.
+template <typename T>
+class BoundedQueue {
+private:
+    queue<T> items;
+    size_t capacity;
+    size_t peak = 0;
+    bool closed = false;
+    mutex lock;
+    condition_variable notFull;
+    condition_variable notEmpty;
+
+public:
+    explicit BoundedQueue(size_t maxItems) : capacity(maxItems) {}
+
+    void push(T item) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this] { return items.size() < capacity; });
+        items.push(move(item));
+        peak = max(peak, items.size());
+        notEmpty.notify_one();
+    }
+
+    // Returns false once the queue is closed and nothing is left in it.
+    bool pop(T& item) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = move(items.front());
+        items.pop();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+    size_t peakDepth() {
+        lock_guard<mutex> guard(lock);
+        return peak;
+    }
+};
+
+// An order travelling through the pipeline, with the promise its caller waits on.
+// The product and address text is looked up once when the order is queued,
+// so the stages never go back to the shared intern tables.
+struct PendingOrder {
+    uint64_t orderId;
+    OrderRecord record;
+    const string* productId;
+    const string* address;
+    string creditCard;
+    promise<bool> result;
+};
+
 
 // --- The Facade ---
 class OrderFacade {
@@ -49,9 +620,142 @@ private:
     InventorySystem inventory;
     PaymentGateway payment;
     ShippingService shipping;
+    OrderLog orderLog;
+
+    // Per-step timings, only collected while profiling is on
+    atomic<bool> profiling{false};
+    LatencyHistogram stockLatency;
+    LatencyHistogram paymentLatency;
+    LatencyHistogram shippingLatency;
+
+    template <typename Quantity>
+    auto checkStock(const string& productId, const Quantity& quantity) {
+        ScopedTimer timer(stockLatency, profiling.load(memory_order_relaxed));
+        return inventory.checkStock(productId, quantity);
+    }
+
+    bool processPayment(const string& creditCard, double amount) {
+        ScopedTimer timer(paymentLatency, profiling.load(memory_order_relaxed));
+        return payment.processPayment(creditCard, amount);
+    }
+
+    template <typename Products>
+    void createShipment(const Products& productIds, const string& address) {
+        ScopedTimer timer(shippingLatency, profiling.load(memory_order_relaxed));
+        shipping.createShipment(productIds, address);
+    }
+
+    InternTable products;
+    InternTable addresses;
+
+    OrderRecord toRecord(const OrderRequest& request) {
+        return {products.intern(request.productId), addresses.intern(request.address),
+                request.quantity, request.price};
+    }
+
+    // Every record made by toRecord() is released once its order is done.
+    void releaseRecord(const OrderRecord& record) {
+        products.release(record.productId);
+        addresses.release(record.addressId);
+    }
+
+    void finishOrder(PendingOrder& order, bool shipped) {
+        releaseRecord(order.record);
+        order.result.set_value(shipped);
+    }
+
+    // The async pipeline: one queue in front of each stage, and a few worker
+    // threads per stage. It is only started by the first placeOrderAsync().
+    static constexpr size_t kQueueCapacity = 64;
+    static constexpr int kWorkersPerStage = 2;
+    BoundedQueue<PendingOrder> inventoryQueue{kQueueCapacity};
+    BoundedQueue<PendingOrder> paymentQueue{kQueueCapacity};
+    BoundedQueue<PendingOrder> shippingQueue{kQueueCapacity};
+    vector<thread> workers;
+    once_flag pipelineStarted;
+
+    // Runs one stage. `handle` returns true when the order moves on to `next`
+    // (nullptr for the last stage). The last worker of a stage to finish
+    // closes the next queue, so shutting down flows through the pipeline.
+    template <typename Handler>
+    void runStage(BoundedQueue<PendingOrder>& in, BoundedQueue<PendingOrder>* next,
+                  shared_ptr<atomic<int>> workersLeft, Handler handle) {
+        PendingOrder order;
+        while (in.pop(order)) {
+            if (handle(order) && next) next->push(move(order));
+        }
+        if (--*workersLeft == 0 && next) next->close();
+    }
+
+    void startPipeline() {
+        auto inventoryLeft = make_shared<atomic<int>>(kWorkersPerStage);
+        auto paymentLeft = make_shared<atomic<int>>(kWorkersPerStage);
+        auto shippingLeft = make_shared<atomic<int>>(kWorkersPerStage);
+
+        for (int i = 0; i < kWorkersPerStage; ++i) {
+            // 1. Check stock
+            workers.emplace_back([this, inventoryLeft] {
+                runStage(inventoryQueue, &paymentQueue, inventoryLeft, [this](PendingOrder& order) {
+                    if (checkStock(*order.productId, order.record.quantity)) return true;
+                    finishOrder(order, false);
+                    return false;
+                });
+            });
+            // 2. Process payment, give the stock back if it fails
+            workers.emplace_back([this, paymentLeft] {
+                runStage(paymentQueue, &shippingQueue, paymentLeft, [this](PendingOrder& order) {
+                    const OrderRecord& r = order.record;
+                    if (processPayment(order.creditCard, r.price * r.quantity)) {
+                        orderLog.record(order.orderId, "PAID");
+                        orderLog.commit();
+                        return true;
+                    }
+                    orderLog.record(order.orderId, "FAILED");
+                    orderLog.commit();
+                    inventory.releaseStock(*order.productId, r.quantity);
+                    finishOrder(order, false);
+                    return false;
+                });
+            });
+            // 3. Create shipment
+            workers.emplace_back([this, shippingLeft] {
+                runStage(shippingQueue, nullptr, shippingLeft, [this](PendingOrder& order) {
+                    createShipment(*order.productId, *order.address);
+                    orderLog.record(order.orderId, "SHIPPED");
+                    orderLog.commit();
+                    inventory.commitStock(*order.productId, order.record.quantity);
+                    finishOrder(order, true);
+                    return false;
+                });
+            });
+        }
+    }
 
 public:
-    OrderFacade() : inventory(), payment(), shipping() {}
+    // Order state changes are kept in the log file at `logPath`, or
+    // nowhere when no path is given.
+    explicit OrderFacade(const string& logPath = "")
+        : inventory(), payment(), shipping(), orderLog(logPath) {
+        for (uint64_t orderId : orderLog.unfinishedOrders()) {
+            cout << "Recovered order " << orderId << ": paid but never shipped, needs attention.\n";
+        }
+    }
+
+    ~OrderFacade() {
+        // Closing the first queue lets every queued order finish first.
+        inventoryQueue.close();
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Filling the warehouse is part of setting the store up, not of the order flow.
+    void addStock(const string& productId, int quantity) {
+        inventory.addStock(productId, quantity);
+    }
+
+    void printStock() const {
+        cout << "Stock:\n";
+        inventory.printStock();
+    }
 
 
     /**
@@ -62,41 +766,202 @@ public:
                     const string& creditCard, double price, 
                     const string& address) 
     {
-        cout << "--- Initiating order process ---" << endl;
+        cout << "--- Initiating order process ---\n";
         bool success = false;
+        uint64_t orderId = orderLog.newOrderId();
 
         // 1. Check stock
-        if (inventory.checkStock(productId, quantity)) {
+        if (checkStock(productId, quantity)) {
             
             // 2. Process payment
-            if (payment.processPayment(creditCard, price * quantity)) {
+            if (processPayment(creditCard, price * quantity)) {
+                orderLog.record(orderId, "PAID");
+                orderLog.commit();
 
                 // 3. Create shipment
-                shipping.createShipment(productId, address);
+                createShipment(productId, address);
+                orderLog.record(orderId, "SHIPPED");
+                orderLog.commit();
+                inventory.commitStock(productId, quantity);
                 success = true;
-                cout << "--- Order process completed successfully! ---" << endl;
+                cout << "--- Order process completed successfully! ---\n";
             
             } else {
-                cout << "--- Order process failed (Payment Error) ---" << endl;
+                orderLog.record(orderId, "FAILED");
+                orderLog.commit();
+                inventory.releaseStock(productId, quantity);
+                cout << "--- Order process failed (Payment Error) ---\n";
             }
         
         } else {
-            cout << "--- Order process failed (Out of Stock) ---" << endl;
+            cout << "--- Order process failed (Out of Stock) ---\n";
         }
 
         return success;
     }
+
+    /**
+     * Places many orders at once (e.g. during a flash sale).
+     * Instead of running the whole chain once per order, each step is run
+     * once per group: one stock check per product, one payment per card,
+     * and one shipment per address. Returns the result of every order,
+     * in the same order as the requests.
+     */
+    vector<bool> placeOrders(const vector<OrderRequest>& orders)
+    {
+        cout << "--- Initiating batch of " << orders.size() << " orders ---\n";
+        vector<OrderRecord> records;
+        records.reserve(orders.size());
+        for (const OrderRequest& order : orders) records.push_back(toRecord(order));
+        vector<uint64_t> orderIds(orders.size());
+        for (uint64_t& orderId : orderIds) orderId = orderLog.newOrderId();
+        vector<bool> success(orders.size(), false);
+
+        // 1. Check (and reserve) stock once per product. Orders get the stock
+        // in the order they were placed, and only those that don't fit fail.
+        map<uint32_t, vector<size_t>> byProduct;
+        for (size_t i = 0; i < records.size(); ++i) {
+            byProduct[records[i].productId].push_back(i);
+        }
+        vector<bool> inStock(orders.size(), false);
+        for (const auto& [productId, indices] : byProduct) {
+            vector<int> quantities;
+            for (size_t i : indices) quantities.push_back(records[i].quantity);
+            vector<bool> fits = checkStock(products.name(productId), quantities);
+            for (size_t k = 0; k < indices.size(); ++k) inStock[indices[k]] = fits[k];
+        }
+
+        // 2. Process one payment per card, for the total amount
+        map<string, vector<size_t>> byCard;
+        for (size_t i = 0; i < orders.size(); ++i) {
+            if (inStock[i]) byCard[orders[i].creditCard].push_back(i);
+        }
+        for (const auto& [creditCard, indices] : byCard) {
+            double total = 0;
+            for (size_t i : indices) total += records[i].price * records[i].quantity;
+            bool paid = processPayment(creditCard, total);
+            for (size_t i : indices) {
+                success[i] = paid;
+                orderLog.record(orderIds[i], paid ? "PAID" : "FAILED");
+            }
+        }
+        orderLog.commit(); // one write for the whole batch
+
+        // 3. Create one shipment per address
+        map<uint32_t, vector<string>> byAddress;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (success[i]) byAddress[records[i].addressId].push_back(products.name(records[i].productId));
+        }
+        for (const auto& [addressId, productIds] : byAddress) {
+            createShipment(productIds, addresses.name(addressId));
+        }
+        for (size_t i = 0; i < orders.size(); ++i) {
+            if (success[i]) orderLog.record(orderIds[i], "SHIPPED");
+        }
+        orderLog.commit();
+
+        // 4. Keep the reservations of paid orders, give back the rest
+        for (size_t i = 0; i < records.size(); ++i) {
+            const string& productId = products.name(records[i].productId);
+            if (success[i]) {
+                inventory.commitStock(productId, records[i].quantity);
+            } else if (inStock[i]) {
+                inventory.releaseStock(productId, records[i].quantity);
+            }
+        }
+        for (const OrderRecord& record : records) releaseRecord(record);
+
+        cout << "--- Batch completed ---\n";
+        return success;
+    }
+
+    /**
+     * Same steps as placeOrder(), but the call returns right away.
+     * The order goes through a pipeline where stock checks, payments and
+     * shipments for different orders run at the same time on their own
+     * worker threads. The future becomes true once the order has shipped.
+     */
+    future<bool> placeOrderAsync(const OrderRequest& request)
+    {
+        call_once(pipelineStarted, [this] { startPipeline(); });
+        OrderRecord record = toRecord(request);
+        PendingOrder order{orderLog.newOrderId(), record, &products.name(record.productId),
+                           &addresses.name(record.addressId), request.creditCard, promise<bool>()};
+        future<bool> result = order.result.get_future();
+        inventoryQueue.push(move(order));
+        return result;
+    }
+
+    // Profiling can be switched on and off while orders are running.
+    void setProfiling(bool enabled)
+    {
+        profiling.store(enabled, memory_order_relaxed);
+    }
+
+    void printLatencyReport()
+    {
+        const pair<const char*, const LatencyHistogram*> steps[] = {
+            {"checkStock", &stockLatency},
+            {"processPayment", &paymentLatency},
+            {"createShipment", &shippingLatency},
+        };
+        cout << "Step latency (ns):\n";
+        for (const auto& [name, histogram] : steps) {
+            LatencyHistogram::Summary step = histogram->summary();
+            cout << "  " << name << ": count " << step.samples
+                 << ", mean " << step.meanNanos()
+                 << ", p50 <" << step.percentileNanos(0.50)
+                 << ", p99 <" << step.percentileNanos(0.99) << "\n";
+        }
+    }
+
+    // Same numbers as printLatencyReport(), as JSON for other tools.
+    string latencyReportJson()
+    {
+        const pair<const char*, const LatencyHistogram*> steps[] = {
+            {"checkStock", &stockLatency},
+            {"processPayment", &paymentLatency},
+            {"createShipment", &shippingLatency},
+        };
+        ostringstream json;
+        json << "{";
+        const char* separator = "";
+        for (const auto& [name, histogram] : steps) {
+            LatencyHistogram::Summary step = histogram->summary();
+            json << separator << "\"" << name << "\": {\"count\": " << step.samples
+                 << ", \"meanNs\": " << step.meanNanos()
+                 << ", \"p50Ns\": " << step.percentileNanos(0.50)
+                 << ", \"p99Ns\": " << step.percentileNanos(0.99) << "}";
+            separator = ", ";
+        }
+        json << "}";
+        return json.str();
+    }
+
+    // How full each stage's queue ever got: the busiest stage is the bottleneck.
+    void printPipelineStats()
+    {
+        cout << "Peak queue depth: inventory " << inventoryQueue.peakDepth()
+             << ", payment " << paymentQueue.peakDepth()
+             << ", shipping " << shippingQueue.peakDepth() << "\n";
+        cout << "Interned strings still in use: " << products.size() << " products, "
+             << addresses.size() << " addresses\n";
+    }
 };
 
 
 // --- The Client ---
-int main() {
+// Run with a file name (./facade_with orders.log) to keep an order log there.
+int main(int argc, char* argv[]) {
     
     // The client only needs to know about the facade
-    OrderFacade orderFacade;
+    OrderFacade orderFacade(argc > 1 ? argv[1] : "");
+    orderFacade.setProfiling(true);
+    orderFacade.addStock("shampoo", 10);
+    orderFacade.addStock("sokar", 5);
 
     // --- Use Case 1: Successful Order ---
-    cout << "Attempting a valid order..." << endl;
+    cout << "Attempting a valid order...\n";
     orderFacade.placeOrder(
         "shampoo", 
         2, 
@@ -106,7 +971,7 @@ int main() {
     );
 
     // --- Use Case 2: Failed Order (Payment) ---
-    cout << "\nAttempting an order with a invalid card..." << endl;
+    cout << "\nAttempting an order with a invalid card...\n";
     orderFacade.placeOrder(
         "sokar", 
         1, 
@@ -115,6 +980,34 @@ int main() {
         "456 Oak Ave, Othertown, USA"
     );
 
+    // --- Use Case 3: A batch of orders ---
+    cout << "\nAttempting a batch of orders...\n";
+    vector<OrderRequest> batch = {
+        {"shampoo", 2, "1", 50.00, "21, masr elgdeda, Egypt"},
+        {"sokar",   3, "1", 10.00, "21, masr elgdeda, Egypt"},
+        {"shampoo", 1, "2", 50.00, "456 Oak Ave, Othertown, USA"},
+        {"sokar",   3, "1", 10.00, "456 Oak Ave, Othertown, USA"}, // only 2 sokar left by now
+    };
+    vector<bool> results = orderFacade.placeOrders(batch);
+    for (size_t i = 0; i < results.size(); ++i) {
+        cout << "Order " << i + 1 << (results[i] ? " succeeded" : " failed") << "\n";
+    }
+
+    // --- Use Case 4: Orders through the async pipeline ---
+    // The steps of different orders run at the same time, so their output mixes.
+    cout << "\nAttempting orders through the async pipeline...\n";
+    vector<future<bool>> pending;
+    pending.push_back(orderFacade.placeOrderAsync({"shampoo", 1, "1", 50.00, "21, masr elgdeda, Egypt"}));
+    pending.push_back(orderFacade.placeOrderAsync({"sokar",   1, "2", 10.00, "456 Oak Ave, Othertown, USA"}));
+    pending.push_back(orderFacade.placeOrderAsync({"shampoo", 1, "1", 50.00, "456 Oak Ave, Othertown, USA"}));
+    for (size_t i = 0; i < pending.size(); ++i) {
+        bool succeeded = pending[i].get(); // wait before printing, or the line gets split
+        cout << "Async order " << i + 1 << (succeeded ? " succeeded" : " failed") << "\n";
+    }
+    orderFacade.printPipelineStats();
+    orderFacade.printStock();
+    orderFacade.printLatencyReport();
+    cout << orderFacade.latencyReportJson() << "\n";
     
     return 0;
 }
\ No newline at end of file
@@ -8,13 +8,13 @@ using namespace std;
 class InventorySystem {
 public:
     bool checkStock(const string& productId, int quantity) {
-        cout << "Checking stock for " << productId << "..." << endl;
+        cout << "Checking stock for " << productId << "...\n";
         // Simulate a real stock check
         if (quantity < 100) {
-            cout << "Stock is available." << endl;
+            cout << "Stock is available.\n";
             return true;
         }
-        cout << "Stock is NOT available." << endl;
+        cout << "Stock is NOT available.\n";
         return false;
     }
 };
@@ -23,12 +23,12 @@ public:
 class PaymentGateway {
 public:
     bool processPayment(const string& creditCard, double amount) {
-        cout << "Processing payment of $" << amount << "..." << endl;
+        cout << "Processing payment of $" << amount << "...\n";
         if (creditCard == "1") { //for example, "1" is a valid card
-            cout << "Payment successful !" << endl;
+            cout << "Payment successful !\n";
             return true;
         }
-        cout << "Payment failed (invalid card)." << endl;
+        cout << "Payment failed (invalid card).\n";
         return false;
     }
 };
@@ -37,8 +37,8 @@ public:
 class ShippingService {
 public:
     void createShipment(const string& productId, const string& address) {
-        cout << "Creating shipment for " << productId << " to " << address << endl;
-        cout << "Shipment created !." << endl;
+        cout << "Creating shipment for " << productId << " to " << address << '\n';
+        cout << "Shipment created !.\n";
     }
 };
 
@@ -52,7 +52,7 @@ int main() {
     ShippingService shipping;
 
     // --- Use Case 1: Successful Order ---
-    cout << "Attempting a valid order..." << endl;
+    cout << "Attempting a valid order...\n";
     
     // --- All this logic was previously hidden inside the Facade ---
     {
@@ -63,7 +63,7 @@ int main() {
         double price = 50.00;
         string address = "21, masr elgdeda, Egypt";
 
-        cout << "--- Initiating order process ---" << endl;
+        cout << "--- Initiating order process ---\n";
         bool success = false;
 
         // 1. Client must call InventorySystem
@@ -75,21 +75,21 @@ int main() {
                 // 3. Client must call ShippingService
                 shipping.createShipment(productId, address);
                 success = true;
-                cout << "--- Order process completed successfully! ---" << endl;
+                cout << "--- Order process completed successfully! ---\n";
             
             } else {
-                cout << "--- Order process failed (Payment Error) ---" << endl;
+                cout << "--- Order process failed (Payment Error) ---\n";
             }
         
         } else {
-            cout << "--- Order process failed (Out of Stock) ---" << endl;
+            cout << "--- Order process failed (Out of Stock) ---\n";
         }
     }
     // --- End of logic for Use Case 1 ---
 
 
     // --- Use Case 2: Failed Order (Payment) ---
-    cout << "\nAttempting an order with a invalid card..." << endl;
+    cout << "\nAttempting an order with a invalid card...\n";
 
     // --- The client must REPEAT all the complex logic ---
     {
@@ -100,7 +100,7 @@ int main() {
         double price = 150.00;
         string address = "456 Oak Ave, Othertown, USA";
 
-        cout << "--- Initiating order process ---" << endl;
+        cout << "--- Initiating order process ---\n";
         bool success = false;
 
         // 1. Client must call InventorySystem again
@@ -112,14 +112,14 @@ int main() {
                 // 3. Client must call ShippingService again
                 shipping.createShipment(productId, address);
                 success = true;
-                cout << "--- Order process completed successfully! ---" << endl;
+                cout << "--- Order process completed successfully! ---\n";
             
             } else {
-                cout << "--- Order process failed (Payment Error) ---" << endl;
+                cout << "--- Order process failed (Payment Error) ---\n";
             }
         
         } else {
-            cout << "--- Order process failed (Out of Stock) ---" << endl;
+            cout << "--- Order process failed (Out of Stock) ---\n";
         }
     }
    
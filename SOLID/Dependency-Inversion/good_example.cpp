@@ -1,47 +1,308 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <memory>
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <cassert>
+#include <algorithm>
 using namespace std;
 
 
+struct InputEvent {
+    enum Kind { KEY, CLICK } kind;
+    int code; // key code or mouse button
+};
+
+// A fixed-size circular queue of events. The computer owns it and lends it
+// to each device, which fills it without allocating anything.
+class EventRing {
+private:
+    static constexpr size_t kCapacity = 256;
+    array<InputEvent, kCapacity> events;
+    size_t head = 0; // next event to read
+    size_t count = 0;
+
+public:
+    bool push(const InputEvent& event) {
+        if (count == kCapacity) return false;
+        events[(head + count) % kCapacity] = event;
+        ++count;
+        return true;
+    }
+
+    bool pop(InputEvent& event) {
+        if (count == 0) return false;
+        event = events[head];
+        head = (head + 1) % kCapacity;
+        --count;
+        return true;
+    }
+
+    size_t freeSpace() const { return kCapacity - count; }
+};
+
 class IInputDevice {
 public:
     virtual void input() = 0;
+    // Moves at most `limit` pending events into the ring (fewer if it
+    // fills up), returns how many.
+    virtual size_t poll(EventRing& ring, size_t limit) = 0;
     virtual ~IInputDevice() {}
 };
 
 class Keyboard : public IInputDevice {
+private:
+    string typed;
+    size_t next = 0;
+
 public:
+    explicit Keyboard(string text = "hi") : typed(move(text)) {}
+
     void input() override {
         cout << "Typing on keyboard..." << endl;
     }
+
+    size_t poll(EventRing& ring, size_t limit) override {
+        size_t moved = 0;
+        while (moved < limit && next < typed.size() && ring.push({InputEvent::KEY, typed[next]})) {
+            ++next;
+            ++moved;
+        }
+        return moved;
+    }
 };
 
 class Mouse : public IInputDevice {
+private:
+    int clicksLeft;
+
 public:
+    explicit Mouse(int clicks = 2) : clicksLeft(clicks) {}
+
     void input() override {
         cout << "Clicking mouse..." << endl;
     }
+
+    size_t poll(EventRing& ring, size_t limit) override {
+        size_t moved = 0;
+        while (moved < limit && clicksLeft > 0 && ring.push({InputEvent::CLICK, 1})) {
+            --clicksLeft;
+            ++moved;
+        }
+        return moved;
+    }
+};
+
+// A fake device that produces events as fast as they can be read,
+// handy for seeing how much each event costs.
+class SyntheticDevice : public IInputDevice {
+private:
+    size_t eventsLeft;
+
+public:
+    explicit SyntheticDevice(size_t events) : eventsLeft(events) {}
+
+    void input() override {
+        cout << "Synthetic device sending " << eventsLeft << " events..." << endl;
+    }
+
+    size_t poll(EventRing& ring, size_t limit) override {
+        size_t batch = min({limit, eventsLeft, ring.freeSpace()});
+        for (size_t i = 0; i < batch; ++i) {
+            ring.push({InputEvent::KEY, static_cast<int>((eventsLeft - i) % 128)});
+        }
+        eventsLeft -= batch;
+        return batch;
+    }
 };
 
 class Computer {
 
 private:
-    IInputDevice* inputDevice;
+    vector<unique_ptr<IInputDevice>> inputDevices; // the computer owns its devices
+    EventRing events;
 
 public:
-    Computer(IInputDevice* device) : inputDevice(device) {}
+    Computer(unique_ptr<IInputDevice> device) {
+        addDevice(move(device));
+    }
+
+    void addDevice(unique_ptr<IInputDevice> device) {
+        inputDevices.push_back(move(device));
+    }
 
     void start() {
+        for (auto& device : inputDevices) {
+            device->input();
+        }
+    }
+
+    // Polls every device in turn and handles whatever they produced,
+    // until no device has anything left. One virtual call per device per
+    // round, not one per event.
+    // Each device gets an equal share of the ring that is still free, so a
+    // busy device can't fill it up and keep the ones after it waiting; what
+    // a quiet device leaves unused goes to the devices after it.
+    void run() {
+        size_t keys = 0, clicks = 0;
+        while (true) {
+            size_t produced = 0;
+            size_t devicesLeft = inputDevices.size();
+            for (auto& device : inputDevices) {
+                size_t share = max<size_t>(1, events.freeSpace() / devicesLeft--);
+                produced += device->poll(events, share);
+            }
+            if (produced == 0) break;
+
+            InputEvent event;
+            while (events.pop(event)) {
+                if (event.kind == InputEvent::KEY) ++keys;
+                else ++clicks;
+            }
+        }
+        cout << "Handled " << keys << " key presses and " << clicks << " clicks." << endl;
+    }
+};
+
+// A tiny dependency injection container.
+// bind<Interface, Impl, Deps...>() says which class to build for an
+// interface, and which other interfaces its constructor needs. resolve()
+// builds the whole graph once at startup. After that, get<Interface>() is
+// just reading a pointer out of an array: no map lookup, no refcounting.
+class Container {
+private:
+    using Owned = unique_ptr<void, void (*)(void*)>;
+
+    // Every interface type gets its own fixed index, the first time it's used.
+    inline static size_t nextSlot = 0;
+    template <typename Interface>
+    static size_t slot() {
+        static const size_t index = nextSlot++;
+        return index;
+    }
+
+    enum class State { UNBOUND, BOUND, BUILDING, BUILT };
+
+    vector<function<Owned(Container&)>> factories;
+    vector<State> states;
+    vector<void*> instances; // what get() reads
+    vector<Owned> owned;     // in build order, destroyed in reverse
+    bool resolved = false;
+
+    void makeRoom(size_t index) {
+        if (index < instances.size()) return;
+        factories.resize(index + 1);
+        states.resize(index + 1, State::UNBOUND);
+        instances.resize(index + 1, nullptr);
+    }
+
+    void build(size_t index) {
+        if (index >= states.size() || states[index] == State::UNBOUND) {
+            throw logic_error("Container: interface was never bound");
+        }
+        if (states[index] == State::BUILT) return;
+        if (states[index] == State::BUILDING) {
+            throw logic_error("Container: dependency cycle");
+        }
+        states[index] = State::BUILDING;
+        Owned object(nullptr, nullptr);
+        try {
+            object = factories[index](*this);
+        } catch (...) {
+            // Every build() on the way back up does the same, so a later
+            // resolve() starts clean instead of seeing a cycle that isn't one
+            states[index] = State::BOUND;
+            throw;
+        }
+        instances[index] = object.get();
+        owned.push_back(move(object));
+        states[index] = State::BUILT;
+    }
+
+    // Used by factories while resolving: builds the dependency first if needed.
+    template <typename Interface>
+    Interface* require() {
+        build(slot<Interface>());
+        return get<Interface>();
+    }
+
+public:
+    Container() = default;
+    Container(const Container&) = delete;
+    Container& operator=(const Container&) = delete;
+
+    ~Container() {
+        while (!owned.empty()) owned.pop_back(); // dependents go before their dependencies
+    }
+
+    template <typename Interface, typename Impl, typename... Deps>
+    void bind() {
+        // Objects built by resolve() already hold their dependencies, a new
+        // binding would never reach them
+        if (resolved) throw logic_error("Container: bind() after resolve()");
+        size_t index = slot<Interface>();
+        makeRoom(index);
+        factories[index] = [](Container& container) {
+            Interface* object = new Impl(container.require<Deps>()...);
+            // Deleted as the Impl it was made as, even if Interface has no
+            // virtual destructor
+            return Owned(object, [](void* p) { delete static_cast<Impl*>(static_cast<Interface*>(p)); });
+        };
+        states[index] = State::BOUND;
+    }
+
+    void resolve() {
+        for (size_t index = 0; index < states.size(); ++index) {
+            if (states[index] != State::UNBOUND) build(index);
+        }
+        resolved = true;
+    }
+
+    // Only valid for bound interfaces, after resolve()
+    template <typename Interface>
+    Interface* get() const {
+        size_t index = slot<Interface>();
+        assert(index < instances.size() && states[index] == State::BUILT);
+        return static_cast<Interface*>(instances[index]);
+    }
+};
+
+// Something that needs an input device, to show the container wiring a dependency
+class Terminal {
+private:
+    IInputDevice* inputDevice;
+
+public:
+    explicit Terminal(IInputDevice* device) : inputDevice(device) {}
+
+    void use() {
+        cout << "Terminal ready. ";
         inputDevice->input();
     }
 };
 
 int main() {
-    Computer computer(new Keyboard()); // it's not tightly coupling anymore !
+    Computer computer(make_unique<Keyboard>()); // it's not tightly coupling anymore !
     computer.start();
 
-    Computer computer2(new Mouse());
+    Computer computer2(make_unique<Mouse>());
     computer2.start();
 
+    // One computer reading from several devices at once
+    Computer workstation(make_unique<Keyboard>("hello"));
+    workstation.addDevice(make_unique<Mouse>(3));
+    workstation.addDevice(make_unique<SyntheticDevice>(1000000));
+    workstation.start();
+    workstation.run();
+
+    // Wiring through the container instead of by hand
+    Container container;
+    container.bind<IInputDevice, Keyboard>();
+    container.bind<Terminal, Terminal, IInputDevice>();
+    container.resolve();
+    container.get<Terminal>()->use();
+
     return 0;
 }
@@ -1,5 +1,13 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <thread>
+#include <type_traits>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <algorithm>
 using namespace std;
 
 class IWorkable {
@@ -23,23 +31,124 @@ public:
 class HumanWorker : public IWorkable, public IEatable, public ISleepable {
 public:
     void work() override {
-        cout << "Human working..." << endl;
+        cout << "Human working...\n";
     }
     void eat() override {
-        cout << "Human eating..." << endl;
+        cout << "Human eating...\n";
     }
     void sleep() override {
-        cout << "Human sleeping..." << endl;
+        cout << "Human sleeping...\n";
     }
 };
 
 class RobotWorker : public IWorkable {
 public:
     void work() override {
-        cout << "Robot working..." << endl;
+        cout << "Robot working...\n";
     }
 };
 
+// Keeps workers in one list per ability (work, eat, sleep). Which lists a
+// worker goes into is decided from its type when it's added, so nobody
+// has to ask every worker "can you eat?" with dynamic_cast later.
+// A tick walks just that one list, split across a pool of threads that the
+// registry starts once and keeps (the workers print each line with a single
+// write, so lines from different threads don't mix).
+class WorkerRegistry {
+private:
+    vector<IWorkable*> workers;
+    vector<IEatable*> eaters;
+    vector<ISleepable*> sleepers;
+
+    // Waking the pool costs more than a short list takes on its own, so
+    // smaller ticks just run on the calling thread.
+    static constexpr size_t kMinParallelTick = 64;
+    static constexpr size_t kChunk = 16; // items a thread takes at a time
+
+    // The current tick, shared with the pool threads
+    vector<thread> pool;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    function<void(size_t)> job; // runs item i of the tick
+    size_t jobSize = 0;
+    atomic<size_t> nextItem{0};
+    size_t busy = 0;            // pool threads still on the current tick
+    uint64_t generation = 0;    // bumped for every tick
+    bool stopping = false;
+
+    void runItems() {
+        for (size_t first = nextItem.fetch_add(kChunk); first < jobSize; first = nextItem.fetch_add(kChunk)) {
+            size_t last = min(first + kChunk, jobSize);
+            for (size_t i = first; i < last; ++i) job(i);
+        }
+    }
+
+    void poolLoop() {
+        uint64_t seen = 0;
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            guard.unlock();
+            runItems();
+            guard.lock();
+            if (--busy == 0) finished.notify_one();
+        }
+    }
+
+    template <typename Ability>
+    void tickAll(const vector<Ability*>& list, void (Ability::*action)()) {
+        if (pool.empty() || list.size() < kMinParallelTick) {
+            for (Ability* item : list) (item->*action)();
+            return;
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            job = [&list, action](size_t i) { (list[i]->*action)(); };
+            jobSize = list.size();
+            nextItem = 0;
+            busy = pool.size();
+            ++generation;
+        }
+        wake.notify_all();
+        runItems(); // the calling thread helps too
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [this] { return busy == 0; });
+    }
+
+public:
+    // `threadCount` includes the thread that calls the ticks.
+    explicit WorkerRegistry(unsigned threadCount = thread::hardware_concurrency()) {
+        for (unsigned t = 1; t < threadCount; ++t) pool.emplace_back([this] { poolLoop(); });
+    }
+
+    WorkerRegistry(const WorkerRegistry&) = delete;
+    WorkerRegistry& operator=(const WorkerRegistry&) = delete;
+
+    ~WorkerRegistry() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : pool) thread.join();
+    }
+
+    // The registry doesn't own the worker, it must outlive the registry.
+    template <typename Worker>
+    void add(Worker& worker) {
+        if constexpr (is_base_of_v<IWorkable, Worker>) workers.push_back(&worker);
+        if constexpr (is_base_of_v<IEatable, Worker>) eaters.push_back(&worker);
+        if constexpr (is_base_of_v<ISleepable, Worker>) sleepers.push_back(&worker);
+    }
+
+    void workTick() { tickAll(workers, &IWorkable::work); }
+    void eatTick() { tickAll(eaters, &IEatable::eat); }
+    void sleepTick() { tickAll(sleepers, &ISleepable::sleep); }
+};
+
 int main() {
     HumanWorker h;
     RobotWorker r;
@@ -49,4 +158,18 @@ int main() {
     h.sleep();
 
     r.work();
+
+    // A mixed crowd: only the humans are asked to eat and sleep
+    vector<HumanWorker> humans(2);
+    vector<RobotWorker> robots(2);
+    WorkerRegistry registry(2);
+    for (auto& human : humans) registry.add(human);
+    for (auto& robot : robots) registry.add(robot);
+
+    cout << "--- work tick ---\n";
+    registry.workTick();
+    cout << "--- eat tick ---\n";
+    registry.eatTick();
+    cout << "--- sleep tick ---\n";
+    registry.sleepTick();
 }
@@ -1,10 +1,14 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdint>
+#include <optional>
 using namespace std;
 
 class Bird {
 public:
+    virtual ~Bird() = default;
     virtual void eat() {
         cout << "I am eating!" << endl;
     }
@@ -35,13 +39,150 @@ void makeFlyingBirdFly(FlyingBird* bird) {
     bird->fly();
 }
 
+// Same idea for a simulation with millions of birds.
+// A bird is just an ID, and every ability (eating, flying, swimming) is its
+// own packed array holding only the birds that have it. The fly step walks
+// the flying array and nothing else: a penguin is never in it, so nobody can
+// ask a penguin to fly, the same guarantee the classes above give us.
+struct Feeding { int meals; };
+struct Flight { float altitude; float speed; };
+struct Swimming { float depth; };
+
+template <typename Component>
+class ComponentArray {
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    vector<Component> data;
+    vector<uint32_t> indexOf; // bird ID -> its entry, kNone if it has none
+
+public:
+    void add(uint32_t bird, Component component) {
+        if (bird >= indexOf.size()) indexOf.resize(bird + 1, kNone);
+        indexOf[bird] = static_cast<uint32_t>(data.size());
+        data.push_back(component);
+    }
+
+    size_t size() const { return data.size(); }
+
+    // nullptr when the bird doesn't have this ability
+    Component* find(uint32_t bird) {
+        if (bird >= indexOf.size() || indexOf[bird] == kNone) return nullptr;
+        return &data[indexOf[bird]];
+    }
+
+    template <typename Visit>
+    void forEach(Visit visit) {
+        for (Component& component : data) visit(component);
+    }
+};
+
+// A look at one bird through one ability, pointing straight into the arrays.
+// You can only get a FlyerView of a bird that flies, and it is a FlyingBird
+// like any other, so code written for the classes above (makeFlyingBirdFly)
+// works on the birds in the world too. A view is only good until the next
+// bird is added, the arrays may move when they grow.
+class FlyerView : public FlyingBird {
+public:
+    uint32_t bird;
+    Feeding& feeding;
+    Flight& flight;
+
+    FlyerView(uint32_t bird, Feeding& feeding, Flight& flight)
+        : bird(bird), feeding(feeding), flight(flight) {}
+
+    void eat() override {
+        ++feeding.meals;
+        cout << "Bird " << bird << " is eating!" << endl;
+    }
+
+    // One second of flight
+    void fly() override {
+        flight.altitude += flight.speed;
+        cout << "Bird " << bird << " is flying!" << endl;
+    }
+};
+
+class SwimmerView : public Bird {
+public:
+    uint32_t bird;
+    Feeding& feeding;
+    Swimming& swimming;
+
+    SwimmerView(uint32_t bird, Feeding& feeding, Swimming& swimming)
+        : bird(bird), feeding(feeding), swimming(swimming) {}
+
+    void eat() override {
+        ++feeding.meals;
+        cout << "Bird " << bird << " is eating!" << endl;
+    }
+
+    // One second of swimming, as deep as swimStep() takes it
+    void swim() {
+        swimming.depth += 1.5f;
+        cout << "Bird " << bird << " is swimming!" << endl;
+    }
+};
+
+class BirdWorld {
+private:
+    uint32_t nextBird = 0;
+    ComponentArray<Feeding> eaters;
+    ComponentArray<Flight> flyers;
+    ComponentArray<Swimming> swimmers;
+
+public:
+    uint32_t addSparrow() {
+        uint32_t bird = nextBird++;
+        eaters.add(bird, {0});
+        flyers.add(bird, {0.0f, 12.0f});
+        return bird;
+    }
+
+    uint32_t addPenguin() {
+        uint32_t bird = nextBird++;
+        eaters.add(bird, {0});
+        swimmers.add(bird, {0.0f});
+        return bird;
+    }
+
+    optional<FlyerView> flyer(uint32_t bird) {
+        Flight* flight = flyers.find(bird);
+        if (!flight) return nullopt;
+        return FlyerView{bird, *eaters.find(bird), *flight};
+    }
+
+    optional<SwimmerView> swimmer(uint32_t bird) {
+        Swimming* swimming = swimmers.find(bird);
+        if (!swimming) return nullopt;
+        return SwimmerView{bird, *eaters.find(bird), *swimming};
+    }
+
+    void eatStep() {
+        eaters.forEach([](Feeding& feeding) { ++feeding.meals; });
+    }
+
+    void flyStep(float seconds) {
+        flyers.forEach([seconds](Flight& flight) { flight.altitude += flight.speed * seconds; });
+    }
+
+    void swimStep(float seconds) {
+        swimmers.forEach([seconds](Swimming& swimming) { swimming.depth += 1.5f * seconds; });
+    }
+
+    void report() const {
+        cout << eaters.size() << " birds eating, " << flyers.size() << " flying, "
+             << swimmers.size() << " swimming" << endl;
+    }
+};
+
 int main() {
-    vector<FlyingBird*> flyingBirds;
-    flyingBirds.push_back(new Sparrow());
-    // flyingBirds.push_back(new Penguin()); // Not allowed: Penguin is not a FlyingBird
+    vector<unique_ptr<FlyingBird>> flyingBirds;
+    flyingBirds.push_back(make_unique<Sparrow>());
+    // flyingBirds.push_back(make_unique<Penguin>()); // Not allowed: Penguin is not a FlyingBird
 
-    for (auto bird : flyingBirds) {
-        makeFlyingBirdFly(bird);
+    for (auto& bird : flyingBirds) {
+        makeFlyingBirdFly(bird.get());
     }
 
     // Example with Penguin
@@ -49,8 +190,28 @@ int main() {
     p.eat();
     p.swim();
 
-    // Cleaning up pointers
-    for (auto bird : flyingBirds) {
-        delete bird;
+    // No cleanup needed, unique_ptr deletes the birds for us
+
+    // A whole flock, stored by ability
+    BirdWorld world;
+    uint32_t sparrowId = world.addSparrow();
+    uint32_t penguinId = world.addPenguin();
+    for (int i = 1; i < 1000; ++i) world.addSparrow();
+    for (int i = 1; i < 200; ++i) world.addPenguin();
+    world.eatStep();
+    world.flyStep(1.0f);
+    world.swimStep(1.0f);
+    world.report();
+
+    // Looking up single birds by the ID they were given
+    if (auto sparrow = world.flyer(sparrowId)) {
+        makeFlyingBirdFly(&*sparrow); // a bird in the world is still a FlyingBird
+        cout << "Bird " << sparrow->bird << " flew to " << sparrow->flight.altitude
+             << "m after " << sparrow->feeding.meals << " meal(s)" << endl;
+    }
+    if (!world.flyer(penguinId)) {
+        cout << "Bird " << penguinId << " can't fly";
+        if (auto penguin = world.swimmer(penguinId)) cout << ", it dove to " << penguin->swimming.depth << "m";
+        cout << endl;
     }
 }
@@ -1,44 +1,469 @@
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+struct Color {
+    std::uint8_t r, g, b;
+};
+
+// An in-memory RGB image the shapes can be drawn into.
+// Shapes draw row by row: for each row they work out where they start and
+// end, and fillRow() paints that run of pixels in one tight loop.
+// band() hands out a canvas that paints into the same pixels but only into
+// some of the rows, so threads can each draw one band at the same time.
+class Canvas {
+    int width, height;
+    std::vector<std::uint8_t> storage; // empty for a band, its pixels belong to the whole canvas
+    std::uint8_t* pixels;              // 3 bytes per pixel, row after row
+    int firstRow, lastRow;             // the rows this canvas may paint
+
+    Canvas(Canvas& whole, int top, int bottom)
+        : width(whole.width), height(whole.height), pixels(whole.pixels),
+          firstRow(std::max(top, whole.firstRow)), lastRow(std::min(bottom, whole.lastRow)) {}
+
+public:
+    Canvas(int w, int h)
+        : width(w), height(h), storage(std::size_t(w) * h * 3, 255), pixels(storage.data()),
+          firstRow(0), lastRow(h - 1) {}
+
+    // A copy would still point at the pixels it was copied from
+    Canvas(const Canvas&) = delete;
+    Canvas& operator=(const Canvas&) = delete;
+
+    // Rows [top, bottom] of this canvas
+    Canvas band(int top, int bottom) { return Canvas(*this, top, bottom); }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getFirstRow() const { return firstRow; }
+    int getLastRow() const { return lastRow; }
+
+    // Paints pixels [x0, x1] of row y, clipped to the canvas (or band).
+    void fillRow(int y, int x0, int x1, Color color) {
+        if (y < firstRow || y > lastRow) return;
+        x0 = std::max(x0, 0);
+        x1 = std::min(x1, width - 1);
+        if (x0 > x1) return; // the whole run is off the canvas
+        std::uint8_t* pixel = &pixels[(std::size_t(y) * width + x0) * 3];
+        for (int x = x0; x <= x1; ++x, pixel += 3) {
+            pixel[0] = color.r;
+            pixel[1] = color.g;
+            pixel[2] = color.b;
+        }
+    }
+
+    // PPM is the simplest image format there is, most image viewers open it.
+    void savePPM(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        file << "P6\n" << width << " " << height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(pixels), std::streamsize(width) * height * 3);
+    }
+};
+
+// An axis-aligned rectangle, edges included
+struct Box {
+    int left, top, right, bottom;
+
+    bool overlaps(const Box& other) const {
+        return left <= other.right && other.left <= right &&
+               top <= other.bottom && other.top <= bottom;
+    }
+};
 
 class Shape {
 public:
     virtual void draw() const = 0; // pure virtual function making the class abstract
+    virtual void rasterize(Canvas& canvas) const = 0;
+    virtual Box bounds() const = 0;
     virtual ~Shape() = default;
 };
 
 class Circle : public Shape {
+    int cx, cy, radius;
 public:
+    Circle(int x = 10, int y = 10, int r = 8) : cx(x), cy(y), radius(r) {}
+
     void draw() const override {
         std::cout << "Drawing Circle\n";
     }
+
+    void rasterize(Canvas& canvas) const override {
+        for (int y = cy - radius; y <= cy + radius; ++y) {
+            int dy = y - cy;
+            int dx = static_cast<int>(std::sqrt(double(radius * radius - dy * dy)));
+            canvas.fillRow(y, cx - dx, cx + dx, {220, 40, 40});
+        }
+    }
+
+    Box bounds() const override {
+        return {cx - radius, cy - radius, cx + radius, cy + radius};
+    }
 };
 
 class Square : public Shape {
+    int left, top, size;
 public:
+    Square(int x = 24, int y = 4, int s = 14) : left(x), top(y), size(s) {}
+
     void draw() const override {
         std::cout << "Drawing Square\n";
     }
+
+    void rasterize(Canvas& canvas) const override {
+        for (int y = top; y < top + size; ++y) {
+            canvas.fillRow(y, left, left + size - 1, {40, 180, 40});
+        }
+    }
+
+    Box bounds() const override {
+        return {left, top, left + size - 1, top + size - 1};
+    }
 };
 
 // adding a new shape requires creating a new class only
 class Triangle : public Shape {
+    int x[3], y[3];
 public:
+    Triangle(int x0 = 48, int y0 = 4, int x1 = 60, int y1 = 20, int x2 = 40, int y2 = 20)
+        : x{x0, x1, x2}, y{y0, y1, y2} {}
+
     void draw() const override {
         std::cout << "Drawing Triangle\n";
     }
+
+    void rasterize(Canvas& canvas) const override {
+        int top = std::min({y[0], y[1], y[2]});
+        int bottom = std::max({y[0], y[1], y[2]});
+        for (int row = top; row <= bottom; ++row) {
+            // Where does this row cross the three edges?
+            double left = 1e9, right = -1e9;
+            for (int i = 0; i < 3; ++i) {
+                int j = (i + 1) % 3;
+                if ((row < y[i]) == (row < y[j]) && row != y[i] && row != y[j]) continue;
+                if (y[i] == y[j]) {
+                    left = std::min({left, double(x[i]), double(x[j])});
+                    right = std::max({right, double(x[i]), double(x[j])});
+                    continue;
+                }
+                double t = double(row - y[i]) / (y[j] - y[i]);
+                double cross = x[i] + t * (x[j] - x[i]);
+                left = std::min(left, cross);
+                right = std::max(right, cross);
+            }
+            if (left <= right) {
+                canvas.fillRow(row, int(std::ceil(left)), int(std::floor(right)), {40, 40, 220});
+            }
+        }
+    }
+
+    Box bounds() const override {
+        return {std::min({x[0], x[1], x[2]}), std::min({y[0], y[1], y[2]}),
+                std::max({x[0], x[1], x[2]}), std::max({y[0], y[1], y[2]})};
+    }
 };
 
-void drawShapes(const std::vector<Shape*>& shapes) {
-    for (auto shape : shapes) {
-        shape->draw(); // no type checking needed
+// A list of different shapes stored by value, back to back in one buffer,
+// instead of one `new` per shape. Each object sits in a slot sized and
+// aligned for its own type, and is still used through the Base interface.
+template <typename Base>
+class PolyVector {
+    // What the container needs to know about each stored type. Reaching the
+    // Base part of an object doesn't go through here, see Slot.
+    struct Ops {
+        void (*moveTo)(void* from, void* to); // move into a new buffer, destroy the old one
+        void (*destroy)(void* object);
+    };
+
+    template <typename T>
+    static constexpr Ops opsFor = {
+        [](void* from, void* to) {
+            T* source = static_cast<T*>(from);
+            new (to) T(std::move(*source));
+            source->~T();
+        },
+        [](void* object) { static_cast<T*>(object)->~T(); },
+    };
+
+    // Where the object starts, and where its Base part starts. Both are
+    // offsets into the buffer, so they stay right when the buffer grows.
+    struct Slot {
+        std::size_t offset;
+        std::size_t baseOffset;
+        const Ops* ops;
+    };
+
+    std::unique_ptr<std::max_align_t[]> buffer;
+    std::size_t capacity = 0; // in bytes
+    std::size_t used = 0;     // in bytes
+    std::vector<Slot> slots;
+
+    std::byte* bytes() const { return reinterpret_cast<std::byte*>(buffer.get()); }
+
+    void grow(std::size_t needed) {
+        std::size_t newCapacity = std::max(needed, capacity * 2);
+        std::size_t blocks = (newCapacity + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        std::unique_ptr<std::max_align_t[]> newBuffer(new std::max_align_t[blocks]);
+        // Offsets stay valid: both buffers start at the strictest alignment.
+        for (const Slot& slot : slots) {
+            slot.ops->moveTo(bytes() + slot.offset,
+                             reinterpret_cast<std::byte*>(newBuffer.get()) + slot.offset);
+        }
+        buffer = std::move(newBuffer);
+        capacity = blocks * sizeof(std::max_align_t);
+    }
+
+public:
+    PolyVector() = default;
+    PolyVector(const PolyVector&) = delete;
+    PolyVector& operator=(const PolyVector&) = delete;
+
+    ~PolyVector() {
+        for (const Slot& slot : slots) slot.ops->destroy(bytes() + slot.offset);
+    }
+
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        static_assert(std::is_base_of_v<Base, T>, "T must derive from Base");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        std::size_t offset = (used + alignof(T) - 1) / alignof(T) * alignof(T);
+        if (offset + sizeof(T) > capacity) grow(offset + sizeof(T));
+        T* object = new (bytes() + offset) T(std::forward<Args>(args)...);
+        std::size_t baseOffset = reinterpret_cast<std::byte*>(static_cast<Base*>(object)) - bytes();
+        slots.push_back({offset, baseOffset, &opsFor<T>});
+        used = offset + sizeof(T);
+        return *object;
+    }
+
+    std::size_t size() const { return slots.size(); }
+
+    // Straight to the Base part, no call through Ops on the way
+    Base& operator[](std::size_t i) { return *std::launder(reinterpret_cast<Base*>(bytes() + slots[i].baseOffset)); }
+    const Base& operator[](std::size_t i) const {
+        return *std::launder(reinterpret_cast<const Base*>(bytes() + slots[i].baseOffset));
+    }
+
+    template <typename Ref, typename Owner>
+    class Iterator {
+        Owner* owner;
+        std::size_t index;
+    public:
+        Iterator(Owner* o, std::size_t i) : owner(o), index(i) {}
+        Ref operator*() const { return (*owner)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+    Iterator<Base&, PolyVector> begin() { return {this, 0}; }
+    Iterator<Base&, PolyVector> end() { return {this, size()}; }
+    Iterator<const Base&, const PolyVector> begin() const { return {this, 0}; }
+    Iterator<const Base&, const PolyVector> end() const { return {this, size()}; }
+};
+
+void drawShapes(const PolyVector<Shape>& shapes) {
+    for (const Shape& shape : shapes) {
+        shape.draw(); // no type checking needed
+    }
+}
+
+// For big scenes: shapes of the same type are kept side by side in their own
+// array, and the arrays are drawn in parallel chunks on several threads.
+// The scene only knows Shape and templates, so a new shape type still needs
+// only its own class, nothing in here changes.
+class ShapeScene {
+    struct IBucket {
+        virtual ~IBucket() = default;
+        virtual std::size_t size() const = 0;
+        virtual void drawRange(std::size_t begin, std::size_t end) const = 0;
+        virtual void rasterizeAll(Canvas& canvas) const = 0;
+    };
+
+    template <typename T>
+    struct Bucket : IBucket {
+        std::vector<T> shapes;
+
+        std::size_t size() const override { return shapes.size(); }
+
+        void drawRange(std::size_t begin, std::size_t end) const override {
+            for (std::size_t i = begin; i < end; ++i) {
+                shapes[i].T::draw(); // the type is known here, so skip the virtual call
+            }
+        }
+
+        // Draws every shape of this type into the canvas in one call,
+        // skipping the ones that are all above or below its rows.
+        void rasterizeAll(Canvas& canvas) const override {
+            for (const T& shape : shapes) {
+                Box box = shape.T::bounds();
+                if (box.bottom < canvas.getFirstRow() || box.top > canvas.getLastRow()) continue;
+                shape.T::rasterize(canvas);
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<IBucket>> buckets;
+    std::unordered_map<std::type_index, IBucket*> bucketOf;
+
+public:
+    template <typename T>
+    void add(T shape) {
+        IBucket*& bucket = bucketOf[typeid(T)];
+        if (!bucket) {
+            buckets.push_back(std::make_unique<Bucket<T>>());
+            bucket = buckets.back().get();
+        }
+        static_cast<Bucket<T>*>(bucket)->shapes.push_back(std::move(shape));
+    }
+
+    // Each thread draws its own slice of every bucket.
+    void draw(unsigned threadCount = std::thread::hardware_concurrency()) const {
+        if (threadCount == 0) threadCount = 1;
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([this, t, threadCount] {
+                for (const auto& bucket : buckets) {
+                    std::size_t size = bucket->size();
+                    bucket->drawRange(size * t / threadCount, size * (t + 1) / threadCount);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+
+    // Overlapping shapes write to the same pixels, so instead of splitting
+    // the shapes, each thread gets a band of rows and draws every shape into
+    // it, in the same order as one thread would. No two threads ever touch
+    // the same pixel, and the picture comes out the same.
+    void rasterize(Canvas& canvas, unsigned threadCount = std::thread::hardware_concurrency()) const {
+        int height = canvas.getHeight();
+        if (threadCount == 0) threadCount = 1;
+        threadCount = std::min<unsigned>(threadCount, std::max(height, 1));
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            int top = int(std::int64_t(height) * t / threadCount);
+            int bottom = int(std::int64_t(height) * (t + 1) / threadCount) - 1;
+            threads.emplace_back([this, &canvas, top, bottom] {
+                Canvas band = canvas.band(top, bottom);
+                for (const auto& bucket : buckets) {
+                    bucket->rasterizeAll(band);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+};
+
+// Splits the world into square cells and remembers which shapes touch
+// which cell. To find what is inside a viewport we only look at the cells
+// the viewport covers instead of at every shape in the scene.
+// It only uses Shape::bounds(), so new shape types work without changes.
+class ShapeGrid {
+    int cellSize;
+    std::unordered_map<std::uint64_t, std::vector<const Shape*>> cells;
+
+    // Shifted as unsigned: shifting a negative signed value is undefined
+    static std::uint64_t key(int cellX, int cellY) {
+        return (std::uint64_t(std::uint32_t(cellX)) << 32) | std::uint32_t(cellY);
+    }
+
+    // Rounds down, also for negative coordinates
+    int cellOf(int coordinate) const {
+        return coordinate >= 0 ? coordinate / cellSize : -((-coordinate - 1) / cellSize) - 1;
+    }
+
+    template <typename Visit>
+    void forEachCell(const Box& box, Visit visit) const {
+        for (int cy = cellOf(box.top); cy <= cellOf(box.bottom); ++cy) {
+            for (int cx = cellOf(box.left); cx <= cellOf(box.right); ++cx) {
+                visit(key(cx, cy));
+            }
+        }
+    }
+
+public:
+    explicit ShapeGrid(int size) : cellSize(size) {}
+
+    void insert(const Shape* shape) {
+        forEachCell(shape->bounds(), [&](std::uint64_t cell) {
+            cells[cell].push_back(shape);
+        });
+    }
+
+    // The shape must not have moved since it was inserted.
+    void remove(const Shape* shape) {
+        forEachCell(shape->bounds(), [&](std::uint64_t cell) {
+            auto it = cells.find(cell);
+            if (it == cells.end()) return;
+            auto& list = it->second;
+            list.erase(std::remove(list.begin(), list.end(), shape), list.end());
+            if (list.empty()) cells.erase(it);
+        });
+    }
+
+    // Every shape whose bounds overlap the viewport, each one once
+    std::vector<const Shape*> query(const Box& viewport) const {
+        std::vector<const Shape*> found;
+        forEachCell(viewport, [&](std::uint64_t cell) {
+            auto it = cells.find(cell);
+            if (it == cells.end()) return;
+            for (const Shape* shape : it->second) {
+                if (shape->bounds().overlaps(viewport)) found.push_back(shape);
+            }
+        });
+        // A big shape sits in several cells, keep only one copy of it
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+        return found;
+    }
+};
+
+void drawVisibleShapes(const ShapeGrid& grid, const Box& viewport) {
+    for (const Shape* shape : grid.query(viewport)) {
+        shape->draw();
     }
 }
 
 int main() {
-    std::vector<Shape*> shapes = { new Circle(), new Square(), new Triangle() };
+    // All three shapes live in one buffer, no new/delete needed
+    PolyVector<Shape> shapes;
+    shapes.emplace<Circle>();
+    shapes.emplace<Square>();
+    shapes.emplace<Triangle>();
     drawShapes(shapes);
 
-    for (auto s : shapes) delete s; // just deleting pointers to clean up the memory
+    // Same shapes in a scene: stored by type, drawn on 2 threads
+    // (so the order of the lines can change from run to run)
+    ShapeScene scene;
+    scene.add(Circle());
+    scene.add(Square());
+    scene.add(Triangle());
+    scene.add(Circle());
+    scene.draw(2);
+
+    // And for real this time: draw the shapes into an image
+    Canvas canvas(64, 24);
+    for (const Shape& shape : shapes) {
+        shape.rasterize(canvas);
+    }
+    canvas.savePPM("shapes.ppm");
+    std::cout << "Saved shapes.ppm\n";
+
+    // Only draw what the camera can see
+    ShapeGrid grid(16);
+    for (const Shape& shape : shapes) {
+        grid.insert(&shape);
+    }
+    std::cout << "Visible in the top-left corner:\n";
+    drawVisibleShapes(grid, {0, 0, 20, 20});
     return 0;
 }
@@ -1,22 +1,106 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <charconv>
+#include <thread>
+#include <string_view>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace std;
 
+// class only keeps one copy of every customer name.
+// Millions of invoices share a few thousand customers, so each invoice
+// stores a number and asks the pool for the name when it needs it.
+class CustomerNamePool {
+public:
+    static CustomerNamePool& shared() {
+        static CustomerNamePool pool;
+        return pool;
+    }
+
+    ~CustomerNamePool() {
+        for (auto& chunk : chunks) delete[] chunk.load();
+    }
+
+    // Most invoices are for a customer the pool already knows, and those
+    // only need the shared (reader) side of the lock.
+    uint32_t intern(string_view name) {
+        {
+            shared_lock<shared_mutex> reader(lock);
+            auto it = ids.find(name);
+            if (it != ids.end()) return it->second;
+        }
+        unique_lock<shared_mutex> writer(lock);
+        auto it = ids.find(name); // someone may have added it in between
+        if (it != ids.end()) return it->second;
+        uint32_t id = count.load(memory_order_relaxed);
+        if (id / kChunkSize == kMaxChunks) throw length_error("CustomerNamePool is full");
+        string* chunk = chunks[id / kChunkSize].load(memory_order_relaxed);
+        if (!chunk) {
+            chunk = new string[kChunkSize];
+            chunks[id / kChunkSize].store(chunk, memory_order_release);
+        }
+        chunk[id % kChunkSize] = name;
+        ids.emplace(chunk[id % kChunkSize], id); // the key views the stored copy
+        count.store(id + 1, memory_order_release);
+        return id;
+    }
+
+    // No lock: names live in fixed-size chunks that never move and are never
+    // freed, so a name stays put once intern() has handed out its ID.
+    // The view stays valid for the whole program.
+    string_view name(uint32_t id) const {
+        return chunks[id / kChunkSize].load(memory_order_acquire)[id % kChunkSize];
+    }
+
+    size_t size() const {
+        return count.load(memory_order_acquire);
+    }
+
+private:
+    static constexpr uint32_t kChunkSize = 1024;
+    static constexpr uint32_t kMaxChunks = 4096; // room for 4M customers
+
+    mutable shared_mutex lock; // guards `ids` and adding names
+    array<atomic<string*>, kMaxChunks> chunks{};
+    atomic<uint32_t> count{0};
+    unordered_map<string_view, uint32_t> ids;
+};
+
 // class only stores invoice data
 class Invoice {
 public:
     Invoice(const string& customer, double amount)
-        : customerName(customer), amount(amount) {}
+        : customerId(CustomerNamePool::shared().intern(customer)), amount(amount) {}
 
-    string getCustomerName() const { return customerName; }
+    string_view getCustomerName() const { return CustomerNamePool::shared().name(customerId); }
+    uint32_t getCustomerId() const { return customerId; }
     double getAmount() const { return amount; }
 
 private:
-    string customerName;
+    uint32_t customerId;
     double amount;
 };
+static_assert(is_trivially_copyable_v<Invoice>, "an Invoice should be cheap to copy");
 
 // handles saving invoice to a file
 class InvoiceFileSaver {
@@ -29,6 +113,264 @@ public:
     }
 };
 
+// Appends the invoice text used by the printer and the savers.
+// to_chars with 6 significant digits writes the amount exactly like cout's
+// default formatting, without going through the stream and its locale.
+void appendInvoiceText(string& out, const Invoice& invoice) {
+    char amount[32];
+    char* end = to_chars(amount, amount + sizeof(amount), invoice.getAmount(),
+                         chars_format::general, 6).ptr;
+    out += "Customer: ";
+    out += invoice.getCustomerName();
+    out += "\nAmount: $";
+    out.append(amount, end);
+    out += '\n';
+}
+
+// Pushes what was written to `file` past the OS cache, onto the disk.
+static bool syncToDisk(FILE* file) {
+    if (fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(file)) == 0;
+#else
+    return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+// handles saving many invoices in a row (e.g. a whole billing run).
+// Invoices are appended to a big in-memory buffer and written to disk in
+// large chunks, instead of opening and closing a file for every invoice.
+// After `invoicesPerFile` invoices it moves on to the next file.
+// A file that failed to open, a short write or a failed sync throws, so a
+// billing run never carries on believing its invoices are saved.
+class InvoiceBatchSaver {
+public:
+    InvoiceBatchSaver(const string& baseName, size_t invoicesPerFile = 100000,
+                      size_t bufferSize = 1 << 20)
+        : baseName(baseName), invoicesPerFile(invoicesPerFile), bufferSize(bufferSize) {
+        buffer.reserve(bufferSize);
+        openNextFile();
+    }
+
+    InvoiceBatchSaver(const InvoiceBatchSaver&) = delete;
+    InvoiceBatchSaver& operator=(const InvoiceBatchSaver&) = delete;
+
+    ~InvoiceBatchSaver() {
+        if (!file) return; // opening the next file failed
+        try {
+            flush();
+        } catch (const exception& error) {
+            cerr << error.what() << "\n";
+        }
+        fclose(file);
+    }
+
+    void save(const Invoice& invoice) {
+        if (invoicesInFile == invoicesPerFile) {
+            flush();
+            openNextFile();
+        }
+        appendInvoiceText(buffer, invoice); // same text as InvoiceFileSaver
+        ++invoicesInFile;
+        if (buffer.size() >= bufferSize) writeBuffer();
+    }
+
+    // Checkpoint: everything saved so far is on the disk, not just handed
+    // to the OS.
+    void flush() {
+        writeBuffer();
+        if (!syncToDisk(file)) throw runtime_error("InvoiceBatchSaver: cannot sync " + currentPath);
+    }
+
+private:
+    void writeBuffer() {
+        size_t size = buffer.size();
+        size_t written = fwrite(buffer.data(), 1, size, file);
+        buffer.clear();
+        if (written != size) throw runtime_error("InvoiceBatchSaver: cannot write " + currentPath);
+    }
+
+    void openNextFile() {
+        if (file) fclose(file);
+        file = nullptr;
+        currentPath = baseName + "_" + to_string(fileIndex++) + ".txt";
+        file = fopen(currentPath.c_str(), "wb");
+        if (!file) throw runtime_error("InvoiceBatchSaver: cannot open " + currentPath);
+        invoicesInFile = 0;
+    }
+
+    string baseName;
+    size_t invoicesPerFile;
+    size_t bufferSize;
+    size_t invoicesInFile = 0;
+    int fileIndex = 0;
+    string currentPath;
+    FILE* file = nullptr;
+    string buffer;
+};
+
+// Binary column format for invoices (what reports read instead of text):
+//   "INVC" | row count | name count | names (length + bytes each)
+//   | block count | min/max amount per block
+//   | customer column (name index per row) | amount column (cents per row)
+// Names are stored once, rows only keep an index into them. Amounts are
+// whole cents so sums are exact. Each block of rows keeps its min/max amount
+// so a scan can skip blocks that can't match.
+constexpr char kInvoiceMagic[4] = {'I', 'N', 'V', 'C'};
+constexpr size_t kInvoiceBlockRows = 4096;
+
+// handles writing invoices in the column format
+class InvoiceColumnWriter {
+public:
+    void add(const Invoice& invoice) {
+        auto [it, inserted] = nameIndex.try_emplace(invoice.getCustomerId(),
+                                                    static_cast<uint32_t>(names.size()));
+        if (inserted) names.push_back(invoice.getCustomerName());
+        customers.push_back(it->second);
+        amounts.push_back(llround(invoice.getAmount() * 100));
+    }
+
+    void writeToFile(const string& path) const {
+        ofstream file(path, ios::binary);
+        file.write(kInvoiceMagic, sizeof(kInvoiceMagic));
+        writeValue(file, static_cast<uint64_t>(amounts.size()));
+        writeValue(file, static_cast<uint32_t>(names.size()));
+        for (string_view name : names) {
+            writeValue(file, static_cast<uint32_t>(name.size()));
+            file.write(name.data(), name.size());
+        }
+        uint64_t blocks = (amounts.size() + kInvoiceBlockRows - 1) / kInvoiceBlockRows;
+        writeValue(file, blocks);
+        for (uint64_t b = 0; b < blocks; ++b) {
+            auto first = amounts.begin() + b * kInvoiceBlockRows;
+            auto last = amounts.begin() + min<size_t>((b + 1) * kInvoiceBlockRows, amounts.size());
+            auto [low, high] = minmax_element(first, last);
+            writeValue(file, *low);
+            writeValue(file, *high);
+        }
+        file.write(reinterpret_cast<const char*>(customers.data()), customers.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(amounts.data()), amounts.size() * sizeof(int64_t));
+    }
+
+private:
+    template <typename T>
+    static void writeValue(ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    unordered_map<uint32_t, uint32_t> nameIndex; // pool ID -> index in this file
+    vector<string_view> names;
+    vector<uint32_t> customers;
+    vector<int64_t> amounts; // cents
+};
+
+// handles reading the column format back and answering questions about it
+class InvoiceColumnReader {
+public:
+    // Reads the whole file with one read, then splits it into columns.
+    // Returns false if the file is missing or not an invoice file, and then
+    // keeps whatever it held before: the columns are only replaced once the
+    // whole file checked out.
+    bool open(const string& path) {
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file) return false;
+        vector<char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(data.data(), data.size())) return false;
+
+        const char* cursor = data.data();
+        const char* end = cursor + data.size();
+        auto left = [&] { return size_t(end - cursor); };
+        auto take = [&](void* out, size_t bytes) {
+            if (size_t(end - cursor) < bytes) return false;
+            memcpy(out, cursor, bytes);
+            cursor += bytes;
+            return true;
+        };
+
+        char magic[4];
+        uint64_t rows = 0, blocks = 0;
+        uint32_t nameCount = 0;
+        if (!take(magic, 4) || memcmp(magic, kInvoiceMagic, 4) != 0) return false;
+        if (!take(&rows, sizeof(rows)) || !take(&nameCount, sizeof(nameCount))) return false;
+        // Counts from the header are checked against what is really in the
+        // file before anything is allocated for them
+        if (nameCount > left() / sizeof(uint32_t)) return false;
+        vector<string> newNames(nameCount);
+        for (string& name : newNames) {
+            uint32_t length = 0;
+            if (!take(&length, sizeof(length)) || size_t(end - cursor) < length) return false;
+            name.assign(cursor, length);
+            cursor += length;
+        }
+        if (!take(&blocks, sizeof(blocks))) return false;
+        if (blocks != (rows + kInvoiceBlockRows - 1) / kInvoiceBlockRows) return false;
+        if (blocks > left() / (2 * sizeof(int64_t))) return false;
+        vector<int64_t> newBlockMin(blocks), newBlockMax(blocks);
+        for (uint64_t b = 0; b < blocks; ++b) {
+            if (!take(&newBlockMin[b], sizeof(int64_t)) || !take(&newBlockMax[b], sizeof(int64_t))) return false;
+        }
+        if (rows != left() / (sizeof(uint32_t) + sizeof(int64_t)) ||
+            left() % (sizeof(uint32_t) + sizeof(int64_t)) != 0) {
+            return false;
+        }
+        vector<uint32_t> newCustomers(rows);
+        vector<int64_t> newAmounts(rows);
+        take(newCustomers.data(), rows * sizeof(uint32_t));
+        take(newAmounts.data(), rows * sizeof(int64_t));
+        for (uint32_t customer : newCustomers) {
+            if (customer >= newNames.size()) return false;
+        }
+
+        names.swap(newNames);
+        blockMin.swap(newBlockMin);
+        blockMax.swap(newBlockMax);
+        customers.swap(newCustomers);
+        amounts.swap(newAmounts);
+        return true;
+    }
+
+    size_t size() const { return amounts.size(); }
+
+    // Total of all invoices at or above `minCents`. Whole blocks whose
+    // largest amount is too small are skipped, and blocks whose smallest
+    // amount is big enough are added up without checking each row.
+    int64_t sumCentsAtLeast(int64_t minCents) const {
+        int64_t total = 0;
+        for (size_t b = 0; b < blockMax.size(); ++b) {
+            if (blockMax[b] < minCents) continue;
+            size_t first = b * kInvoiceBlockRows;
+            size_t last = min(first + kInvoiceBlockRows, amounts.size());
+            if (blockMin[b] >= minCents) {
+                total = accumulate(amounts.begin() + first, amounts.begin() + last, total);
+                continue;
+            }
+            for (size_t i = first; i < last; ++i) {
+                if (amounts[i] >= minCents) total += amounts[i];
+            }
+        }
+        return total;
+    }
+
+    map<string, int64_t> sumCentsByCustomer() const {
+        vector<int64_t> totals(names.size(), 0);
+        for (size_t i = 0; i < amounts.size(); ++i) {
+            totals[customers[i]] += amounts[i];
+        }
+        map<string, int64_t> result;
+        for (size_t n = 0; n < names.size(); ++n) result[names[n]] = totals[n];
+        return result;
+    }
+
+private:
+    vector<string> names;
+    vector<int64_t> blockMin, blockMax;
+    vector<uint32_t> customers;
+    vector<int64_t> amounts; // cents
+};
+
 // handles printing invoice to console
 class InvoicePrinter {
 public:
@@ -38,6 +380,100 @@ public:
     }
 };
 
+// handles printing many invoices to console at once.
+// Each thread formats its own slice of the invoices into its own buffer,
+// then the buffers are written out in order, so the output is the same as
+// calling InvoicePrinter::print on each invoice one by one.
+class InvoiceBatchPrinter {
+public:
+    void print(const vector<Invoice>& invoices,
+               unsigned threadCount = thread::hardware_concurrency()) {
+        if (threadCount == 0) threadCount = 1;
+        vector<string> buffers(threadCount);
+        vector<thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                size_t first = invoices.size() * t / threadCount;
+                size_t last = invoices.size() * (t + 1) / threadCount;
+                for (size_t i = first; i < last; ++i) {
+                    appendInvoiceText(buffers[t], invoices[i]);
+                }
+            });
+        }
+        for (auto& worker : threads) worker.join();
+        for (const string& buffer : buffers) {
+            cout.write(buffer.data(), buffer.size());
+        }
+    }
+};
+
+// handles totaling invoices for billing.
+// Amounts are kept as whole cents in one flat array, so sums are exact and
+// the loops below are simple enough for the compiler to vectorize.
+class InvoiceTotals {
+public:
+    void add(const Invoice& invoice) {
+        amounts.push_back(llround(invoice.getAmount() * 100));
+        customers.push_back(invoice.getCustomerId());
+    }
+
+    int64_t sumCents() const {
+        int64_t total = 0;
+        for (int64_t amount : amounts) total += amount;
+        return total;
+    }
+
+    int64_t minCents() const {
+        return amounts.empty() ? 0 : *min_element(amounts.begin(), amounts.end());
+    }
+
+    int64_t maxCents() const {
+        return amounts.empty() ? 0 : *max_element(amounts.begin(), amounts.end());
+    }
+
+    // Customer IDs are small and dense, so totals go into a plain array
+    // indexed by ID. Each thread sums its own slice into its own array,
+    // and the arrays are added up at the end.
+    map<string, int64_t> sumCentsByCustomer(unsigned threadCount = thread::hardware_concurrency()) const {
+        if (threadCount == 0) threadCount = 1;
+        size_t customerCount = CustomerNamePool::shared().size();
+        struct Partial {
+            vector<int64_t> cents;
+            vector<size_t> invoices; // tells a $0 customer apart from an absent one
+        };
+        vector<Partial> partial(threadCount, {vector<int64_t>(customerCount, 0), vector<size_t>(customerCount, 0)});
+        vector<thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                size_t first = amounts.size() * t / threadCount;
+                size_t last = amounts.size() * (t + 1) / threadCount;
+                Partial& mine = partial[t];
+                for (size_t i = first; i < last; ++i) {
+                    mine.cents[customers[i]] += amounts[i];
+                    ++mine.invoices[customers[i]];
+                }
+            });
+        }
+        for (auto& worker : threads) worker.join();
+
+        map<string, int64_t> result;
+        for (size_t id = 0; id < customerCount; ++id) {
+            int64_t total = 0;
+            size_t invoices = 0;
+            for (const Partial& part : partial) {
+                total += part.cents[id];
+                invoices += part.invoices[id];
+            }
+            if (invoices > 0) result[string(CustomerNamePool::shared().name(static_cast<uint32_t>(id)))] = total;
+        }
+        return result;
+    }
+
+private:
+    vector<int64_t> amounts; // cents
+    vector<uint32_t> customers;
+};
+
 int main() {
     Invoice invoice("Ahmed", 250.0);
     InvoicePrinter printer;
@@ -45,4 +481,42 @@ int main() {
 
     printer.print(invoice);
     saver.saveToFile(invoice);
+
+    // a billing run: many invoices, two per file to show the rotation
+    InvoiceBatchSaver batchSaver("invoices", 2);
+    batchSaver.save(Invoice("Ahmed", 250.0));
+    batchSaver.save(Invoice("Mona", 99.5));
+    batchSaver.save(Invoice("Omar", 1200.75));
+    batchSaver.flush();
+
+    // printing a whole batch on 2 threads
+    InvoiceBatchPrinter batchPrinter;
+    batchPrinter.print({Invoice("Ahmed", 250.0), Invoice("Mona", 99.5), Invoice("Omar", 1200.75)}, 2);
+
+    // billing totals
+    InvoiceTotals totals;
+    totals.add(Invoice("Ahmed", 250.0));
+    totals.add(Invoice("Mona", 99.5));
+    totals.add(Invoice("Ahmed", 1200.75));
+    cout << "Sum: $" << totals.sumCents() / 100.0
+         << ", min: $" << totals.minCents() / 100.0
+         << ", max: $" << totals.maxCents() / 100.0 << "\n";
+    for (const auto& [customer, cents] : totals.sumCentsByCustomer(2)) {
+        cout << customer << " owes $" << cents / 100.0 << "\n";
+    }
+
+    // the same invoices in the column format, then a report from it
+    InvoiceColumnWriter columnWriter;
+    columnWriter.add(Invoice("Ahmed", 250.0));
+    columnWriter.add(Invoice("Mona", 99.5));
+    columnWriter.add(Invoice("Ahmed", 1200.75));
+    columnWriter.writeToFile("invoices.col");
+
+    InvoiceColumnReader columnReader;
+    if (columnReader.open("invoices.col")) {
+        for (const auto& [customer, cents] : columnReader.sumCentsByCustomer()) {
+            cout << customer << " total: $" << cents / 100.0 << "\n";
+        }
+        cout << "Invoices of $100 or more: $" << columnReader.sumCentsAtLeast(10000) / 100.0 << "\n";
+    }
 }
@@ -0,0 +1,19 @@
+// Abstract Factory, with the pattern: one factory object spawns a matching
+// boss and support for the level.
+#define main example_main
+#include "../Design-Patterns/Creational/Abstract-Factory-Pattern/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void spawnGang(bench::State& state) {
+    shared_ptr<IEnemyFactory> factory = make_shared<GoblinSquadFactory>();
+    while (state.keepRunning()) {
+        auto boss = factory->spawnBoss();
+        auto support = factory->spawnSupport();
+        boss->attack();
+        support->support();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("AbstractFactory/with/spawnGang", spawnGang);
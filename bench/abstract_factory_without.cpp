@@ -0,0 +1,27 @@
+// Abstract Factory, without the pattern: the level check from the example's
+// main() picks both enemy classes by hand.
+#define main example_main
+#include "../Design-Patterns/Creational/Abstract-Factory-Pattern/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void spawnGang(bench::State& state) {
+    int level = 2;
+    bench::doNotOptimize(level);
+    while (state.keepRunning()) {
+        if (level == 1) {
+            SkeletonGiant boss;
+            boss.attack();
+            SkeletonBomber support;
+            support.support();
+        } else {
+            GoblinGiant boss;
+            boss.attack();
+            SpearGoblin support;
+            support.support();
+        }
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("AbstractFactory/without/spawnGang", spawnGang);
@@ -0,0 +1,184 @@
+// Adapter, with the pattern: the client pays through IPaymentGateway and the
+// adapter translates the call for Stripe or PayPal. Also times the batch calls,
+// the connection pool and the idempotency keys built on top of it.
+#define main example_main
+#include "../Design-Patterns/Structural/Adapter-Pattern/OOP/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+
+static void processOrderStripe(bench::State& state) {
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    while (state.keepRunning()) {
+        processOrder(&stripeGateway, 150.75);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Adapter/with/processOrder/stripe", processOrderStripe);
+
+static void processOrderPayPal(bench::State& state) {
+    PayPalAPI paypalService;
+    PayPalAdapter paypalGateway(&paypalService, "customer@example.com", "pay_paypal456");
+    while (state.keepRunning()) {
+        processOrder(&paypalGateway, 89.99);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Adapter/with/processOrder/paypal", processOrderPayPal);
+
+// range() payments one call at a time, against the same payments as one batch
+static vector<double> amounts(size_t count) {
+    vector<double> result(count);
+    for (size_t i = 0; i < count; ++i) result[i] = 1.0 + i % 100;
+    return result;
+}
+
+static void payEach(bench::State& state) {
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    vector<double> cart = amounts(state.range());
+    while (state.keepRunning()) {
+        for (double amount : cart) stripeGateway.pay(amount);
+    }
+    state.setItemsProcessed(state.iterations() * cart.size());
+}
+BENCHMARK_ARGS("Adapter/with/payEach", payEach, 10, 1000);
+
+static void payBatch(bench::State& state) {
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    vector<double> cart = amounts(state.range());
+    while (state.keepRunning()) {
+        stripeGateway.payBatch(cart);
+    }
+    state.setItemsProcessed(state.iterations() * cart.size());
+}
+BENCHMARK_ARGS("Adapter/with/payBatch", payBatch, 10, 1000);
+
+// 64 payments in flight at once through range() pooled connections
+static constexpr int kInFlight = 64;
+
+static void pooledPay(bench::State& state) {
+    StripeAPI stripeService;
+    PaymentGatewayPool pool;
+    for (int i = 0; i < state.range(); ++i) {
+        pool.addConnection(make_unique<StripeAdapter>(&stripeService, "1234-5678-9012-3456",
+                                                      "txn_stripe" + to_string(i)));
+    }
+    vector<future<void>> inFlight;
+    inFlight.reserve(kInFlight);
+    while (state.keepRunning()) {
+        for (int i = 0; i < kInFlight; ++i) inFlight.push_back(pool.payAsync(30.0 + i));
+        for (auto& payment : inFlight) payment.get();
+        inFlight.clear();
+    }
+    state.setItemsProcessed(state.iterations() * kInFlight);
+}
+BENCHMARK_ARGS("Adapter/with/pooledPay", pooledPay, 1, 2, 4);
+
+// The same 64 payments, one after the other on the calling thread
+static void sequentialPay(bench::State& state) {
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    while (state.keepRunning()) {
+        for (int i = 0; i < kInFlight; ++i) stripeGateway.pay(30.0 + i);
+    }
+    state.setItemsProcessed(state.iterations() * kInFlight);
+}
+BENCHMARK("Adapter/with/sequentialPay", sequentialPay);
+
+// Every payment has a new key, so each one goes through the cache and the
+// provider: the cost of the keys on top of a plain pay().
+static void idempotentPay(bench::State& state) {
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    IdempotentPaymentGateway safeGateway(&stripeGateway);
+    unsigned long long order = 0;
+    while (state.keepRunning()) {
+        safeGateway.pay("order-" + to_string(order++), 99.99);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Adapter/with/idempotentPay", idempotentPay);
+
+// The client retries the same order over and over: only the first call pays.
+static void idempotentRetry(bench::State& state) {
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    IdempotentPaymentGateway safeGateway(&stripeGateway);
+    while (state.keepRunning()) {
+        safeGateway.pay("order-1001", 99.99);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Adapter/with/idempotentRetry", idempotentRetry);
+
+// Logging at a high call rate. cout goes to a file while these run (instead
+// of the runner's sink, which costs nothing), so writing and flushing it
+// costs what it would in a real program.
+static const char* kLogPath = "bench_log.txt";
+
+struct CoutToFile {
+    ofstream file{kLogPath};
+    streambuf* previous = cout.rdbuf(file.rdbuf());
+
+    ~CoutToFile() {
+        cout.rdbuf(previous);
+        file.close();
+        remove(kLogPath);
+    }
+};
+
+static const string kLine = "Stripe: Charging card '1234-5678-9012-3456' for 150.75 USD.\n";
+
+// Lines from range() threads: cout with endl under a lock (a flush and a
+// system call per line), against the async log. A writer only waits for
+// the flusher when its ring is full; lines still in the rings when the
+// threads finish are written after the clock stops.
+static void logEndl(bench::State& state) {
+    CoutToFile redirect;
+    mutex lock;
+    state.runThreaded(static_cast<unsigned>(state.range()), [&](unsigned, uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            lock_guard<mutex> guard(lock);
+            cout << string_view(kLine.data(), kLine.size() - 1) << endl;
+        }
+    });
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_ARGS("Adapter/with/log/coutEndl", logEndl, 1, 4);
+
+static void logAsync(bench::State& state) {
+    CoutToFile redirect;
+    AsyncLog log(cout);
+    state.runThreaded(static_cast<unsigned>(state.range()), [&](unsigned, uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) log.write(kLine);
+    });
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_ARGS("Adapter/with/log/async", logAsync, 1, 4);
+
+// Stripe payments from range() threads, each logging its two lines through
+// ConsoleLine to cout or to the async log.
+static void payLogged(bench::State& state, bool async) {
+    CoutToFile redirect;
+    optional<AsyncLog> log; // its flusher would write to cout too
+    if (async) ConsoleLine::sendTo(&log.emplace(cout));
+    StripeAPI stripeService;
+    StripeAdapter stripeGateway(&stripeService, "1234-5678-9012-3456", "txn_stripe123");
+    state.runThreaded(static_cast<unsigned>(state.range()), [&](unsigned, uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) stripeGateway.pay(150.75);
+    });
+    ConsoleLine::sendTo(nullptr);
+    state.setItemsProcessed(state.iterations());
+}
+
+static void payToCout(bench::State& state) { payLogged(state, false); }
+static void payToAsyncLog(bench::State& state) { payLogged(state, true); }
+BENCHMARK_ARGS("Adapter/with/log/pay/cout", payToCout, 1, 4);
+BENCHMARK_ARGS("Adapter/with/log/pay/async", payToAsyncLog, 1, 4);
@@ -0,0 +1,25 @@
+// Adapter, without the pattern: the client checks the gateway name and talks
+// to each provider's own API itself.
+#define main example_main
+#include "../Design-Patterns/Structural/Adapter-Pattern/OOP/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void processOrderStripe(bench::State& state) {
+    const std::string gateway = "stripe";
+    while (state.keepRunning()) {
+        processOrder(gateway, 150.75);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Adapter/without/processOrder/stripe", processOrderStripe);
+
+static void processOrderPayPal(bench::State& state) {
+    const std::string gateway = "paypal";
+    while (state.keepRunning()) {
+        processOrder(gateway, 89.99);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Adapter/without/processOrder/paypal", processOrderPayPal);
@@ -0,0 +1,22 @@
+// Command, with the pattern: a button press looks its command up by name and
+// runs it through a virtual execute().
+#define main example_main
+#include "../Design-Patterns/Behavioral/Command-Pattern/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void pressButton(bench::State& state) {
+    Lamp lamp;
+    RemoteControl remote;
+    remote.setCommand("green", make_shared<TurnOnCommand>(&lamp));
+    remote.setCommand("red", make_shared<TurnOffCommand>(&lamp));
+
+    const string buttons[] = {"green", "red"};
+    size_t next = 0;
+    while (state.keepRunning()) {
+        remote.pressButton(buttons[next++ & 1]);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Command/with/pressButton", pressButton);
@@ -0,0 +1,20 @@
+// Command, without the pattern: a button press compares the name against
+// every button the RemoteControl knows.
+#define main example_main
+#include "../Design-Patterns/Behavioral/Command-Pattern/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void pressButton(bench::State& state) {
+    Lamp lamp;
+    RemoteControl remote(&lamp);
+
+    const string buttons[] = {"green", "red"};
+    size_t next = 0;
+    while (state.keepRunning()) {
+        remote.pressButton(buttons[next++ & 1]);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Command/without/pressButton", pressButton);
@@ -0,0 +1,45 @@
+// Decorator, with the pattern: each request wraps the blog post in one
+// decorator per role, all inside a per-request arena on the stack, then
+// generates the JSON.
+#define main example_main
+#include "../Design-Patterns/Structural/Decorator-Pattern/OOP/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+#include "harness/count_allocations.h"
+
+// The first range() roles of AUTHOR, EDITOR, DEBUGGER
+static vector<UserRole> firstRoles(int64_t count) {
+    vector<UserRole> all = {UserRole::AUTHOR, UserRole::EDITOR, UserRole::DEBUGGER};
+    return vector<UserRole>(all.begin(), all.begin() + count);
+}
+
+static void request(bench::State& state) {
+    vector<UserRole> roles = firstRoles(state.range());
+    uint64_t allocationsBefore = bench::heapAllocations;
+    while (state.keepRunning()) {
+        alignas(max_align_t) byte buffer[kArenaBytes];
+        pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+        ResponsePtr response = buildResponse(roles, arena);
+        JsonString json = response->generate();
+        bench::doNotOptimize(json);
+    }
+    state.counters["heapAllocs/request"] =
+        double(bench::heapAllocations - allocationsBefore) / state.iterations();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_ARGS("Decorator/with/request", request, 0, 2, 3);
+
+// The busy server from main(), with 20000 requests, on range() threads
+static void serveRequests(bench::State& state) {
+    vector<vector<UserRole>> requests;
+    for (int i = 0; i < 10000; ++i) {
+        requests.push_back({});
+        requests.push_back({UserRole::AUTHOR, UserRole::EDITOR, UserRole::DEBUGGER});
+    }
+    while (state.keepRunning()) {
+        bench::doNotOptimize(serveRequests(requests, static_cast<unsigned>(state.range())));
+    }
+    state.setItemsProcessed(state.iterations() * requests.size());
+}
+BENCHMARK_ARGS("Decorator/with/serveRequests", serveRequests, 1, 2, 4);
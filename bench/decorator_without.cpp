@@ -0,0 +1,45 @@
+// Decorator, without the pattern: the request handler picks one of the
+// combination classes from the role set and makes it on the heap, as
+// handleApiRequest() does, then generates the JSON.
+#define main example_main
+#include "../Design-Patterns/Structural/Decorator-Pattern/OOP/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+#include "harness/count_allocations.h"
+
+// The first range() roles of AUTHOR, EDITOR, DEBUGGER
+static std::vector<UserRole> firstRoles(std::int64_t count) {
+    std::vector<UserRole> all = {UserRole::AUTHOR, UserRole::EDITOR, UserRole::DEBUGGER};
+    return std::vector<UserRole>(all.begin(), all.begin() + count);
+}
+
+static void request(bench::State& state) {
+    std::vector<UserRole> roles = firstRoles(state.range());
+    std::uint64_t allocationsBefore = bench::heapAllocations;
+    while (state.keepRunning()) {
+        std::unique_ptr<ApiResponse> response;
+        std::set<UserRole> roleSet(roles.begin(), roles.end());
+        bool isAuthor = roleSet.count(UserRole::AUTHOR);
+        bool isEditor = roleSet.count(UserRole::EDITOR);
+        bool isDebugger = roleSet.count(UserRole::DEBUGGER);
+
+        if (isAuthor && isEditor && isDebugger) {
+            response = std::make_unique<BlogPostAllRolesResponse>(101);
+        } else if (isAuthor && isEditor) {
+            response = std::make_unique<BlogPostAuthorEditorResponse>(101);
+        } else if (isAuthor) {
+            response = std::make_unique<BlogPostAuthorResponse>(101);
+        } else if (isEditor) {
+            response = std::make_unique<BlogPostEditorResponse>(101);
+        } else {
+            response = std::make_unique<BlogPostResponse>(101);
+        }
+        JsonString json = response->generate();
+        bench::doNotOptimize(json);
+    }
+    state.counters["heapAllocs/request"] =
+        double(bench::heapAllocations - allocationsBefore) / state.iterations();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_ARGS("Decorator/without/request", request, 0, 2, 3);
@@ -0,0 +1,15 @@
+// Dependency Inversion, bad: the Computer makes its own Keyboard.
+#define main example_main
+#include "../SOLID/Dependency-Inversion/bad_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void start(bench::State& state) {
+    Computer computer;
+    while (state.keepRunning()) {
+        computer.start();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("DependencyInversion/bad/start", start);
@@ -0,0 +1,67 @@
+// Dependency Inversion, good: the Computer only knows IInputDevice. Also
+// times the event polling and the container built on that interface.
+#define main example_main
+#include "../SOLID/Dependency-Inversion/good_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void start(bench::State& state) {
+    Computer computer(make_unique<Keyboard>());
+    while (state.keepRunning()) {
+        computer.start();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("DependencyInversion/good/start", start);
+
+// Reading a million events from a device through the ring
+static constexpr size_t kEvents = 1000000;
+
+static void runEvents(bench::State& state) {
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        Computer computer(make_unique<SyntheticDevice>(kEvents));
+        state.resumeTiming();
+        computer.run();
+    }
+    state.setItemsProcessed(state.iterations() * kEvents);
+}
+BENCHMARK("DependencyInversion/good/run", runEvents);
+
+// get<>() after resolve(), against holding the pointer yourself
+static void containerGet(bench::State& state) {
+    Container container;
+    container.bind<IInputDevice, Keyboard>();
+    container.bind<Terminal, Terminal, IInputDevice>();
+    container.resolve();
+    while (state.keepRunning()) {
+        bench::doNotOptimize(container.get<Terminal>());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("DependencyInversion/good/container/get", containerGet);
+
+static void directPointer(bench::State& state) {
+    Keyboard keyboard;
+    Terminal terminal(&keyboard);
+    Terminal* pointer = &terminal;
+    while (state.keepRunning()) {
+        bench::doNotOptimize(pointer);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("DependencyInversion/good/container/directPointer", directPointer);
+
+// Wiring the example's two bindings from scratch
+static void bindAndResolve(bench::State& state) {
+    while (state.keepRunning()) {
+        Container container;
+        container.bind<IInputDevice, Keyboard>();
+        container.bind<Terminal, Terminal, IInputDevice>();
+        container.resolve();
+        bench::doNotOptimize(container.get<Terminal>());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("DependencyInversion/good/container/bindAndResolve", bindAndResolve);
@@ -0,0 +1,173 @@
+// Facade, with the pattern: the client places an order with one call and the
+// facade runs stock, payment and shipping. The order log is off unless the
+// name says "logged", so the times are the facade's own; the log is timed on
+// its own further down. Also times the batch and async paths and the pieces
+// they are built from.
+#define main example_main
+#include "../Design-Patterns/Structural/Facade-Pattern/OOP/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static const char* kLogPath = "bench_orders.log";
+
+// Declared before the facade: starts every benchmark from an empty log and
+// removes it once the facade has closed it.
+struct FreshLog {
+    FreshLog() { remove(kLogPath); }
+    ~FreshLog() { remove(kLogPath); }
+};
+
+static constexpr int kPlentyOfStock = 2000000000;
+
+static void placeOrder(bench::State& state, bool logged, bool profiled) {
+    FreshLog log;
+    OrderFacade facade(logged ? kLogPath : "");
+    facade.setProfiling(profiled);
+    facade.addStock("shampoo", kPlentyOfStock);
+    while (state.keepRunning()) {
+        facade.placeOrder("shampoo", 1, "1", 50.00, "21, masr elgdeda, Egypt");
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+static void placeOrderPlain(bench::State& state) { placeOrder(state, false, false); }
+static void placeOrderProfiled(bench::State& state) { placeOrder(state, false, true); }
+static void placeOrderLogged(bench::State& state) { placeOrder(state, true, false); }
+BENCHMARK("Facade/with/placeOrder", placeOrderPlain);
+// The same with the per-step latency histograms switched on
+BENCHMARK("Facade/with/placeOrder/profiled", placeOrderProfiled);
+// The same with every step written to the log and synced
+BENCHMARK("Facade/with/placeOrder/logged", placeOrderLogged);
+
+// range() orders spread over 4 products and 8 addresses, all paid with one card
+static vector<OrderRequest> makeOrders(size_t count) {
+    vector<OrderRequest> orders;
+    for (size_t i = 0; i < count; ++i) {
+        orders.push_back({"product-" + to_string(i % 4), 1, "1", 10.00,
+                          to_string(i % 8) + " Bench Street"});
+    }
+    return orders;
+}
+
+static void placeOrders(bench::State& state) {
+    OrderFacade facade;
+    for (int i = 0; i < 4; ++i) facade.addStock("product-" + to_string(i), kPlentyOfStock);
+    vector<OrderRequest> orders = makeOrders(state.range());
+    while (state.keepRunning()) {
+        bench::doNotOptimize(facade.placeOrders(orders));
+    }
+    state.setItemsProcessed(state.iterations() * orders.size());
+}
+BENCHMARK_ARGS("Facade/with/placeOrders", placeOrders, 1, 16, 256);
+
+// The same orders one placeOrder() at a time, for comparison
+static void placeOrderLoop(bench::State& state) {
+    OrderFacade facade;
+    for (int i = 0; i < 4; ++i) facade.addStock("product-" + to_string(i), kPlentyOfStock);
+    vector<OrderRequest> orders = makeOrders(state.range());
+    while (state.keepRunning()) {
+        for (const OrderRequest& order : orders) {
+            facade.placeOrder(order.productId, order.quantity, order.creditCard, order.price, order.address);
+        }
+    }
+    state.setItemsProcessed(state.iterations() * orders.size());
+}
+BENCHMARK_ARGS("Facade/with/placeOrderLoop", placeOrderLoop, 16);
+
+// range() orders in the async pipeline at once, then wait for all of them
+static void placeOrderAsync(bench::State& state) {
+    OrderFacade facade;
+    for (int i = 0; i < 4; ++i) facade.addStock("product-" + to_string(i), kPlentyOfStock);
+    vector<OrderRequest> orders = makeOrders(state.range());
+    vector<future<bool>> pending;
+    pending.reserve(orders.size());
+    while (state.keepRunning()) {
+        for (const OrderRequest& order : orders) pending.push_back(facade.placeOrderAsync(order));
+        for (auto& order : pending) bench::doNotOptimize(order.get());
+        pending.clear();
+    }
+    state.setItemsProcessed(state.iterations() * orders.size());
+}
+BENCHMARK_ARGS("Facade/with/placeOrderAsync", placeOrderAsync, 1, 16, 256);
+
+// Reserving and committing stock on range() threads, all for the same product
+// (hot) or each thread for its own product (cold).
+static void reserve(bench::State& state, bool sameProduct) {
+    InventorySystem inventory;
+    const unsigned threads = static_cast<unsigned>(state.range());
+    for (unsigned t = 0; t < threads; ++t) inventory.addStock("sku-" + to_string(t), kPlentyOfStock);
+    state.runThreaded(threads, [&](unsigned thread, uint64_t count) {
+        const string productId = "sku-" + to_string(sameProduct ? 0 : thread);
+        for (uint64_t i = 0; i < count; ++i) {
+            if (inventory.checkStock(productId, 1)) inventory.commitStock(productId, 1);
+        }
+    });
+    state.setItemsProcessed(state.iterations());
+}
+
+static void reserveHot(bench::State& state) { reserve(state, true); }
+static void reserveCold(bench::State& state) { reserve(state, false); }
+BENCHMARK_ARGS("Facade/with/reserve/hot", reserveHot, 1, 2, 4);
+BENCHMARK_ARGS("Facade/with/reserve/cold", reserveCold, 1, 2, 4);
+
+// What an order in a queue or batch costs to carry around: the compact
+// record with interned IDs, against the request with its own strings.
+static void internAndRelease(bench::State& state) {
+    InternTable addresses;
+    const string address = "21, masr elgdeda, Egypt";
+    uint32_t keepAlive = addresses.intern(address);
+    while (state.keepRunning()) {
+        addresses.release(addresses.intern(address));
+    }
+    addresses.release(keepAlive);
+    state.counters["bytes/OrderRecord"] = sizeof(OrderRecord);
+    state.counters["bytes/OrderRequest"] = sizeof(OrderRequest);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Facade/with/internAndRelease", internAndRelease);
+
+// range() log records written and synced with one commit()
+static void logCommit(bench::State& state) {
+    FreshLog fresh;
+    OrderLog log(kLogPath);
+    const int64_t records = state.range();
+    while (state.keepRunning()) {
+        for (int64_t i = 0; i < records; ++i) log.record(log.newOrderId(), "PAID");
+        log.commit();
+    }
+    state.setItemsProcessed(state.iterations() * records);
+}
+BENCHMARK_ARGS("Facade/with/logCommit", logCommit, 1, 64);
+
+// range() threads each recording one order and waiting for it to be on the
+// disk, as the facade does. With group commit a thread's commit() also writes
+// the records the others made meanwhile; without it every record is synced
+// on its own.
+static void concurrentCommit(bench::State& state, bool groupCommit) {
+    FreshLog fresh;
+    OrderLog log(kLogPath, groupCommit);
+    state.runThreaded(static_cast<unsigned>(state.range()), [&](unsigned, uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            log.record(log.newOrderId(), "PAID");
+            log.commit();
+        }
+    });
+    state.setItemsProcessed(state.iterations());
+}
+
+static void groupCommitOn(bench::State& state) { concurrentCommit(state, true); }
+static void groupCommitOff(bench::State& state) { concurrentCommit(state, false); }
+BENCHMARK_ARGS("Facade/with/concurrentCommit/group", groupCommitOn, 1, 4, 16);
+BENCHMARK_ARGS("Facade/with/concurrentCommit/eachRecord", groupCommitOff, 1, 4, 16);
+
+// One latency sample recorded from each of range() threads
+static void histogramRecord(bench::State& state) {
+    LatencyHistogram histogram;
+    state.runThreaded(static_cast<unsigned>(state.range()), [&](unsigned, uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) histogram.record(i & 0xffff);
+    });
+    bench::doNotOptimize(histogram.summary().samples);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_ARGS("Facade/with/histogramRecord", histogramRecord, 1, 2, 4);
@@ -0,0 +1,30 @@
+// Facade, without the pattern: the client calls stock, payment and shipping
+// itself, the same steps the example's main() repeats for every order.
+#define main example_main
+#include "../Design-Patterns/Structural/Facade-Pattern/OOP/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void placeOrder(bench::State& state) {
+    InventorySystem inventory;
+    PaymentGateway payment;
+    ShippingService shipping;
+    const string productId = "shampoo";
+    const string creditCard = "1";
+    const string address = "21, masr elgdeda, Egypt";
+    while (state.keepRunning()) {
+        int quantity = 1;
+        double price = 50.00;
+        bool success = false;
+        if (inventory.checkStock(productId, quantity)) {
+            if (payment.processPayment(creditCard, price * quantity)) {
+                shipping.createShipment(productId, address);
+                success = true;
+            }
+        }
+        bench::doNotOptimize(success);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Facade/without/placeOrder", placeOrder);
@@ -0,0 +1,26 @@
+// Factory, with the pattern: the game asks a factory object for an enemy and
+// never names the concrete class.
+#define main example_main
+#include "../Design-Patterns/Creational/Factory-Pattern/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void spawn(bench::State& state, shared_ptr<IEnemyFactory> spawner) {
+    while (state.keepRunning()) {
+        shared_ptr<Ienemy> enemy = spawner->createEnemy();
+        enemy->attack();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+static void randomSpawn(bench::State& state) {
+    srand(1);
+    spawn(state, make_shared<randomEnemySpawn>());
+}
+BENCHMARK("Factory/with/randomSpawn", randomSpawn);
+
+static void byLevelSpawn(bench::State& state) {
+    spawn(state, make_shared<byLevelEnemySpawn>(7));
+}
+BENCHMARK("Factory/with/byLevelSpawn", byLevelSpawn);
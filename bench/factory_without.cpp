@@ -0,0 +1,43 @@
+// Factory, without the pattern: the if/else chains from the example's main(),
+// picking the enemy class right where it is used.
+#define main example_main
+#include "../Design-Patterns/Creational/Factory-Pattern/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void randomSpawn(bench::State& state) {
+    srand(1);
+    while (state.keepRunning()) {
+        int enemyType = rand() % 3;
+        shared_ptr<Ienemy> enemy;
+        if (enemyType == 0) {
+            enemy = make_shared<Goblin>();
+        } else if (enemyType == 1) {
+            enemy = make_shared<Dragon>();
+        } else if (enemyType == 2) {
+            enemy = make_shared<Wizard>();
+        }
+        enemy->attack();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Factory/without/randomSpawn", randomSpawn);
+
+static void byLevelSpawn(bench::State& state) {
+    int playerLevel = 7;
+    bench::doNotOptimize(playerLevel);
+    while (state.keepRunning()) {
+        shared_ptr<Ienemy> enemy;
+        if (playerLevel > 0 && playerLevel < 5) {
+            enemy = make_shared<Goblin>();
+        } else if (playerLevel >= 5 && playerLevel < 10) {
+            enemy = make_shared<Dragon>();
+        } else {
+            enemy = make_shared<Wizard>();
+        }
+        enemy->attack();
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Factory/without/byLevelSpawn", byLevelSpawn);
@@ -0,0 +1,134 @@
+#pragma once
+
+// A small stand-in for Google Benchmark, so the benchmarks build with
+// nothing but a C++17 compiler (same as the examples). A benchmark is a
+// function that does its setup, then repeats the code being measured:
+//
+//   static void pressButton(bench::State& state) {
+//       RemoteControl remote;                 // setup, not timed
+//       while (state.keepRunning()) {
+//           remote.pressButton("green");      // timed
+//       }
+//   }
+//   BENCHMARK("Command/with/pressButton", pressButton);
+//
+// The runner calls it with more and more iterations until the timed part
+// takes long enough, then reports the time of one iteration. Everything
+// the examples print to cout is thrown away while they run.
+//
+// Each benchmark program includes one example .cpp with its main() renamed,
+// so the benchmarks use the example's own classes as they are:
+//
+//   #define main example_main
+//   #include "../Design-Patterns/Behavioral/Command-Pattern/with_example.cpp"
+//   #undef main
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+class State {
+public:
+    State(std::uint64_t iterations, std::int64_t argument)
+        : maxIterations(iterations), arg(argument) {}
+
+    // Starts the clock on the first call, stops it once every iteration ran.
+    bool keepRunning() {
+        if (done == 0 && !timing) resumeTiming();
+        if (done == maxIterations) {
+            pauseTiming();
+            return false;
+        }
+        ++done;
+        return true;
+    }
+
+    // For setup that has to happen inside the loop
+    void pauseTiming() {
+        if (!timing) return;
+        elapsed += Clock::now() - startedAt;
+        timing = false;
+    }
+
+    void resumeTiming() {
+        startedAt = Clock::now();
+        timing = true;
+    }
+
+    // Runs every iteration at once, split between `threads` threads, instead
+    // of a keepRunning() loop. Each thread calls work(thread, count) for its
+    // share. Starting the threads is part of the time.
+    template <typename Work>
+    void runThreaded(unsigned threads, Work work) {
+        std::vector<std::thread> workers;
+        resumeTiming();
+        for (unsigned t = 0; t < threads; ++t) {
+            std::uint64_t count = maxIterations / threads + (t < maxIterations % threads ? 1 : 0);
+            workers.emplace_back(work, t, count);
+        }
+        for (auto& worker : workers) worker.join();
+        pauseTiming();
+        done = maxIterations;
+    }
+
+    std::uint64_t iterations() const { return maxIterations; }
+
+    // The value given to BENCHMARK_ARGS, 0 for a plain BENCHMARK
+    std::int64_t range() const { return arg; }
+
+    // Reported per second next to the time
+    void setItemsProcessed(std::uint64_t items) { itemsProcessed = items; }
+    void setBytesProcessed(std::uint64_t bytes) { bytesProcessed = bytes; }
+
+    // Extra numbers reported as they are (memory per item, allocations ...)
+    std::map<std::string, double> counters;
+
+    double seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+    std::uint64_t items() const { return itemsProcessed; }
+    std::uint64_t bytes() const { return bytesProcessed; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t maxIterations;
+    std::uint64_t done = 0;
+    std::int64_t arg;
+    bool timing = false;
+    Clock::time_point startedAt;
+    Clock::duration elapsed{0};
+    std::uint64_t itemsProcessed = 0;
+    std::uint64_t bytesProcessed = 0;
+};
+
+// Keeps the compiler from optimizing away a result nobody reads.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+using Function = void (*)(State&);
+
+// Registers one benchmark per argument (or one with argument 0).
+int add(const char* name, Function function, std::vector<std::int64_t> arguments = {});
+
+} // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+#define BENCHMARK(name, function) \
+    static const int BENCH_CONCAT(benchRegistered, __LINE__) = bench::add(name, function)
+
+// The benchmark runs once per argument, named "<name>/<argument>"
+#define BENCHMARK_ARGS(name, function, ...) \
+    static const int BENCH_CONCAT(benchRegistered, __LINE__) = bench::add(name, function, {__VA_ARGS__})
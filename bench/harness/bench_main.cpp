@@ -0,0 +1,127 @@
+// Runs every benchmark registered in this program and prints one line each.
+//
+//   ./bench_facade_with                 run them all
+//   ./bench_facade_with placeOrder      only those whose name contains "placeOrder"
+//   ./bench_facade_with --min-time=1    time each one for at least 1 second
+//   ./bench_facade_with --no-header     skip the column titles
+
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+namespace bench {
+namespace {
+
+struct Benchmark {
+    std::string name;
+    Function function;
+    std::int64_t argument;
+};
+
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+// A stream buffer that throws everything away.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int ch) override { return traits_type::not_eof(ch); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Formats a rate like Google Benchmark does: 12.3k/s, 4.56M/s ...
+std::string perSecond(double value, const char* unit) {
+    const char* prefixes[] = {"", "k", "M", "G", "T"};
+    int prefix = 0;
+    while (value >= 1000 && prefix < 4) {
+        value /= 1000;
+        ++prefix;
+    }
+    char text[64];
+    std::snprintf(text, sizeof(text), "%s=%.3g%s%s/s", unit, value, prefixes[prefix],
+                  std::strcmp(unit, "bytes") == 0 ? "B" : "");
+    return text;
+}
+
+void report(const Benchmark& benchmark, const State& state) {
+    double nanos = state.seconds() * 1e9 / double(state.iterations());
+    std::string extra;
+    if (state.items() > 0) extra += " " + perSecond(state.items() / state.seconds(), "items");
+    if (state.bytes() > 0) extra += " " + perSecond(state.bytes() / state.seconds(), "bytes");
+    for (const auto& [name, value] : state.counters) {
+        char text[96];
+        std::snprintf(text, sizeof(text), " %s=%.4g", name.c_str(), value);
+        extra += text;
+    }
+    std::printf("%-56s %14.1f ns %12llu%s\n", benchmark.name.c_str(), nanos,
+                static_cast<unsigned long long>(state.iterations()), extra.c_str());
+    std::fflush(stdout);
+}
+
+// Same idea as Google Benchmark: start with one iteration and grow the
+// count until one run of the benchmark takes at least `minSeconds`.
+void run(const Benchmark& benchmark, double minSeconds) {
+    NullBuffer sink;
+    std::uint64_t iterations = 1;
+    while (true) {
+        State state(iterations, benchmark.argument);
+        std::streambuf* console = std::cout.rdbuf(&sink);
+        benchmark.function(state);
+        std::cout.rdbuf(console);
+
+        double seconds = state.seconds();
+        if (seconds >= minSeconds || iterations >= 1000000000) {
+            report(benchmark, state);
+            return;
+        }
+        double grow = seconds <= 0 ? 10.0 : std::min(10.0, 1.4 * minSeconds / seconds);
+        iterations = std::max(iterations + 1, static_cast<std::uint64_t>(iterations * grow));
+    }
+}
+
+} // namespace
+
+int add(const char* name, Function function, std::vector<std::int64_t> arguments) {
+    if (arguments.empty()) {
+        registry().push_back({name, function, 0});
+    } else {
+        for (std::int64_t argument : arguments) {
+            registry().push_back({std::string(name) + "/" + std::to_string(argument), function, argument});
+        }
+    }
+    return 0;
+}
+
+} // namespace bench
+
+int main(int argc, char** argv) {
+    std::string filter;
+    double minSeconds = 0.2;
+    bool header = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option.rfind("--min-time=", 0) == 0) {
+            minSeconds = std::stod(option.substr(11));
+        } else if (option == "--no-header") {
+            header = false;
+        } else {
+            filter = option;
+        }
+    }
+
+    if (header) {
+        std::printf("%-56s %17s %12s\n", "Benchmark", "Time", "Iterations");
+        std::printf("%s\n", std::string(87, '-').c_str());
+    }
+    for (const auto& benchmark : bench::registry()) {
+        if (benchmark.name.find(filter) == std::string::npos) continue;
+        bench::run(benchmark, minSeconds);
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Counts every heap allocation the program makes, by replacing the global
+// operator new. Include it in one file of a benchmark program only, and read
+// bench::heapAllocations before and after the code you are interested in.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+inline std::atomic<std::uint64_t> heapAllocations{0};
+inline std::atomic<std::uint64_t> heapBytes{0};
+} // namespace bench
+
+// GCC sees operator new and free() meet once both are inlined, and warns
+// about a mismatch that is not there: this operator new calls malloc().
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    bench::heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    bench::heapBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,23 @@
+// Interface Segregation, bad: every worker has eat(), so robots get called
+// too and print nonsense.
+#define main example_main
+#include "../SOLID/Interface-Segregation/bad_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+#include <vector>
+
+static void eatAll(bench::State& state) {
+    std::vector<HumanWorker> humans(10000);
+    std::vector<RobotWorker> robots(10000);
+    std::vector<IWorker*> everyone;
+    for (size_t i = 0; i < humans.size(); ++i) {
+        everyone.push_back(&humans[i]);
+        everyone.push_back(&robots[i]);
+    }
+    while (state.keepRunning()) {
+        for (IWorker* worker : everyone) worker->eat();
+    }
+    state.setItemsProcessed(state.iterations() * everyone.size());
+}
+BENCHMARK("InterfaceSegregation/bad/eatAll", eatAll);
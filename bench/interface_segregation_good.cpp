@@ -0,0 +1,41 @@
+// Interface Segregation, good: workers only implement the abilities they
+// have, and the registry keeps one list per ability. An eat tick walks the
+// eaters only, on range() threads.
+#define main example_main
+#include "../SOLID/Interface-Segregation/good_exmaple.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static constexpr int kEachKind = 10000;
+
+static void eatTick(bench::State& state) {
+    vector<HumanWorker> humans(kEachKind);
+    vector<RobotWorker> robots(kEachKind);
+    WorkerRegistry registry(static_cast<unsigned>(state.range()));
+    for (auto& human : humans) registry.add(human);
+    for (auto& robot : robots) registry.add(robot);
+    while (state.keepRunning()) {
+        registry.eatTick();
+    }
+    state.setItemsProcessed(state.iterations() * kEachKind);
+}
+BENCHMARK_ARGS("InterfaceSegregation/good/registry/eatTick", eatTick, 1, 2, 4);
+
+// Without the registry: ask every worker whether it can eat
+static void dynamicCastEat(bench::State& state) {
+    vector<HumanWorker> humans(kEachKind);
+    vector<RobotWorker> robots(kEachKind);
+    vector<IWorkable*> everyone;
+    for (int i = 0; i < kEachKind; ++i) {
+        everyone.push_back(&humans[i]);
+        everyone.push_back(&robots[i]);
+    }
+    while (state.keepRunning()) {
+        for (IWorkable* worker : everyone) {
+            if (auto* eater = dynamic_cast<IEatable*>(worker)) eater->eat();
+        }
+    }
+    state.setItemsProcessed(state.iterations() * kEachKind);
+}
+BENCHMARK("InterfaceSegregation/good/dynamicCastEat", dynamicCastEat);
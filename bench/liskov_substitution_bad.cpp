@@ -0,0 +1,21 @@
+// Liskov Substitution, bad: every Bird can be asked to fly, penguins too.
+#define main example_main
+#include "../SOLID/Liskov-Substitution/bad_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void makeBirdsFly(bench::State& state) {
+    // Bird has no virtual destructor, so the birds are not deleted through Bird*
+    vector<Sparrow> sparrows(1000);
+    vector<Penguin> penguins(1000);
+    vector<Bird*> birds;
+    for (int i = 0; i < 1000; ++i) {
+        birds.push_back(i % 6 == 5 ? static_cast<Bird*>(&penguins[i]) : &sparrows[i]);
+    }
+    while (state.keepRunning()) {
+        for (auto bird : birds) makeBirdFly(bird);
+    }
+    state.setItemsProcessed(state.iterations() * birds.size());
+}
+BENCHMARK("LiskovSubstitution/bad/makeBirdFly", makeBirdsFly);
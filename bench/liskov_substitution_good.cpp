@@ -0,0 +1,74 @@
+// Liskov Substitution, good: only FlyingBirds are ever asked to fly. Also
+// times the BirdWorld that stores a big flock by ability.
+#define main example_main
+#include "../SOLID/Liskov-Substitution/good_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void makeFlyingBirdsFly(bench::State& state) {
+    vector<unique_ptr<FlyingBird>> flyingBirds;
+    for (int i = 0; i < 1000; ++i) flyingBirds.push_back(make_unique<Sparrow>());
+    while (state.keepRunning()) {
+        for (auto& bird : flyingBirds) makeFlyingBirdFly(bird.get());
+    }
+    state.setItemsProcessed(state.iterations() * flyingBirds.size());
+}
+BENCHMARK("LiskovSubstitution/good/makeFlyingBirdFly", makeFlyingBirdsFly);
+
+// A flock of a million sparrows and 200000 penguins
+static void makeFlock(BirdWorld& world) {
+    for (int i = 0; i < 1200000; ++i) {
+        if (i % 6 == 5) {
+            world.addPenguin();
+        } else {
+            world.addSparrow();
+        }
+    }
+}
+
+static void flyStep(bench::State& state) {
+    BirdWorld world;
+    makeFlock(world);
+    while (state.keepRunning()) {
+        world.flyStep(1.0f);
+    }
+    state.setItemsProcessed(state.iterations() * 1000000);
+}
+BENCHMARK("LiskovSubstitution/good/world/flyStep", flyStep);
+
+static void eatStep(bench::State& state) {
+    BirdWorld world;
+    makeFlock(world);
+    while (state.keepRunning()) {
+        world.eatStep();
+    }
+    state.setItemsProcessed(state.iterations() * 1200000);
+}
+BENCHMARK("LiskovSubstitution/good/world/eatStep", eatStep);
+
+// Looking single birds up by ID, penguins included
+static void flyerLookup(bench::State& state) {
+    BirdWorld world;
+    makeFlock(world);
+    uint32_t bird = 0;
+    while (state.keepRunning()) {
+        bird = (bird + 7919) % 1200000;
+        if (auto sparrow = world.flyer(bird)) bench::doNotOptimize(sparrow->flight.altitude);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("LiskovSubstitution/good/world/flyerLookup", flyerLookup);
+
+// The same makeFlyingBirdFly() on birds living in the world, through views
+static void worldFlyingBirdFly(bench::State& state) {
+    BirdWorld world;
+    makeFlock(world);
+    uint32_t bird = 0;
+    while (state.keepRunning()) {
+        bird = (bird + 7919) % 1200000;
+        if (auto sparrow = world.flyer(bird)) makeFlyingBirdFly(&*sparrow);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("LiskovSubstitution/good/world/makeFlyingBirdFly", worldFlyingBirdFly);
@@ -0,0 +1,21 @@
+// Observer, with the pattern: a price change walks the subscriber list and
+// makes one virtual update() call per investor.
+#define main example_main
+#include "../Design-Patterns/Behavioral/Observer-Pattern/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void setPrice(bench::State& state) {
+    const int investors = static_cast<int>(state.range());
+    Stock stock;
+    for (int i = 0; i < investors; ++i) {
+        stock.add(make_shared<Investor>("Investor " + to_string(i)));
+    }
+    float price = 100.0f;
+    while (state.keepRunning()) {
+        stock.setPrice(price += 0.25f);
+    }
+    state.setItemsProcessed(state.iterations() * investors);
+}
+BENCHMARK_ARGS("Observer/with/setPrice", setPrice, 3, 100);
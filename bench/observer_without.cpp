@@ -0,0 +1,17 @@
+// Observer, without the pattern: a price change calls update() on three
+// investors the StockMarket holds by value.
+#define main example_main
+#include "../Design-Patterns/Behavioral/Observer-Pattern/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void setPrice(bench::State& state) {
+    StockMarket market;
+    float price = 100.0f;
+    while (state.keepRunning()) {
+        market.setPrice(price += 0.25f);
+    }
+    state.setItemsProcessed(state.iterations() * 3);
+}
+BENCHMARK("Observer/without/setPrice/3", setPrice);
@@ -0,0 +1,22 @@
+// Open-Closed, bad: drawShapes() checks every shape's type field and
+// knows how to draw each one itself.
+#define main example_main
+#include "../SOLID/Open-Closed/bad_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static constexpr int kShapes = 10000;
+
+static void drawShapes(bench::State& state) {
+    std::vector<Shape*> shapes;
+    for (int i = 0; i < kShapes; ++i) {
+        shapes.push_back(i % 2 == 0 ? static_cast<Shape*>(new Circle()) : new Square());
+    }
+    while (state.keepRunning()) {
+        drawShapes(shapes);
+    }
+    for (auto s : shapes) delete s;
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/bad/drawShapes", drawShapes);
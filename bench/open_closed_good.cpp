@@ -0,0 +1,181 @@
+// Open-Closed, good: every shape draws itself through the Shape interface,
+// so drawShapes() never checks types. Also times the containers, the
+// threaded scene, the rasterizer and the grid built on that interface.
+#define main example_main
+#include "../SOLID/Open-Closed/good_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+#include "harness/count_allocations.h"
+
+static constexpr int kShapes = 10000;
+
+// Circles and squares taking turns, like the bad example can hold
+static void fill(PolyVector<Shape>& shapes, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            shapes.emplace<Circle>();
+        } else {
+            shapes.emplace<Square>();
+        }
+    }
+}
+
+static void fill(std::vector<std::unique_ptr<Shape>>& shapes, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            shapes.push_back(std::make_unique<Circle>());
+        } else {
+            shapes.push_back(std::make_unique<Square>());
+        }
+    }
+}
+
+static void drawShapes(bench::State& state) {
+    PolyVector<Shape> shapes;
+    fill(shapes, kShapes);
+    while (state.keepRunning()) {
+        drawShapes(shapes);
+    }
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/good/drawShapes", drawShapes);
+
+// Building the list: one buffer for all the shapes, against one new per shape
+static void buildPolyVector(bench::State& state) {
+    std::uint64_t allocationsBefore = bench::heapAllocations;
+    while (state.keepRunning()) {
+        PolyVector<Shape> shapes;
+        fill(shapes, kShapes);
+        bench::doNotOptimize(shapes.size());
+    }
+    state.counters["heapAllocs/shape"] =
+        double(bench::heapAllocations - allocationsBefore) / (double(state.iterations()) * kShapes);
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/good/build/polyVector", buildPolyVector);
+
+static void buildUniquePtrs(bench::State& state) {
+    std::uint64_t allocationsBefore = bench::heapAllocations;
+    while (state.keepRunning()) {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        fill(shapes, kShapes);
+        bench::doNotOptimize(shapes.size());
+    }
+    state.counters["heapAllocs/shape"] =
+        double(bench::heapAllocations - allocationsBefore) / (double(state.iterations()) * kShapes);
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/good/build/uniquePtrs", buildUniquePtrs);
+
+// Walking the list with a virtual call that does not print
+static void boundsPolyVector(bench::State& state) {
+    PolyVector<Shape> shapes;
+    fill(shapes, kShapes);
+    while (state.keepRunning()) {
+        int right = 0;
+        for (const Shape& shape : shapes) right += shape.bounds().right;
+        bench::doNotOptimize(right);
+    }
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/good/bounds/polyVector", boundsPolyVector);
+
+static void boundsUniquePtrs(bench::State& state) {
+    std::vector<std::unique_ptr<Shape>> shapes;
+    fill(shapes, kShapes);
+    while (state.keepRunning()) {
+        int right = 0;
+        for (const auto& shape : shapes) right += shape->bounds().right;
+        bench::doNotOptimize(right);
+    }
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/good/bounds/uniquePtrs", boundsUniquePtrs);
+
+// The scene draws each type's array without virtual calls, on range() threads
+static void sceneDraw(bench::State& state) {
+    ShapeScene scene;
+    for (int i = 0; i < kShapes; ++i) {
+        if (i % 2 == 0) {
+            scene.add(Circle());
+        } else {
+            scene.add(Square());
+        }
+    }
+    while (state.keepRunning()) {
+        scene.draw(static_cast<unsigned>(state.range()));
+    }
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK_ARGS("OpenClosed/good/scene/draw", sceneDraw, 1, 2, 4);
+
+static void drawUniquePtrs(bench::State& state) {
+    std::vector<std::unique_ptr<Shape>> shapes;
+    fill(shapes, kShapes);
+    while (state.keepRunning()) {
+        for (const auto& shape : shapes) shape->draw();
+    }
+    state.setItemsProcessed(state.iterations() * kShapes);
+}
+BENCHMARK("OpenClosed/good/scene/drawUniquePtrs", drawUniquePtrs);
+
+// 1000 shapes of every type, scattered over a 1024x768 canvas split into
+// range() bands. pixels/s counts the whole canvas once per rasterize().
+static void rasterize(bench::State& state) {
+    ShapeScene scene;
+    for (int i = 0; i < 1000; ++i) {
+        int x = i * 97 % 1024, y = i * 61 % 768, size = 8 + i % 32;
+        scene.add(Circle(x, y, size));
+        scene.add(Square(x, y, size));
+        scene.add(Triangle(x, y, x + size, y + size, x - size, y + size));
+    }
+    Canvas canvas(1024, 768);
+    while (state.keepRunning()) {
+        scene.rasterize(canvas, static_cast<unsigned>(state.range()));
+    }
+    state.setItemsProcessed(state.iterations() * 3000);
+    state.counters["pixels/s"] = double(state.iterations()) * 1024 * 768 / state.seconds();
+}
+BENCHMARK_ARGS("OpenClosed/good/rasterize", rasterize, 1, 2, 4);
+
+// Finding the shapes in a 256x256 viewport among 100000 spread over a
+// 4096x4096 world: the grid against checking every shape.
+static constexpr int kWorldShapes = 100000;
+
+static void scatter(PolyVector<Shape>& shapes) {
+    for (int i = 0; i < kWorldShapes; ++i) {
+        shapes.emplace<Circle>(int(std::uint32_t(i) * 2654435761u % 4096), int(std::uint32_t(i) * 40503u % 4096), 4 + i % 16);
+    }
+}
+
+static void gridQuery(bench::State& state) {
+    PolyVector<Shape> shapes;
+    scatter(shapes);
+    ShapeGrid grid(64);
+    for (const Shape& shape : shapes) grid.insert(&shape);
+    int corner = 0;
+    while (state.keepRunning()) {
+        int x = corner++ * 256 % 3840;
+        bench::doNotOptimize(grid.query({x, x, x + 255, x + 255}).size());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("OpenClosed/good/visible/gridQuery", gridQuery);
+
+static void fullScan(bench::State& state) {
+    PolyVector<Shape> shapes;
+    scatter(shapes);
+    int corner = 0;
+    while (state.keepRunning()) {
+        int x = corner++ * 256 % 3840;
+        Box viewport{x, x, x + 255, x + 255};
+        std::vector<const Shape*> found;
+        for (const Shape& shape : shapes) {
+            if (shape.bounds().overlaps(viewport)) found.push_back(&shape);
+        }
+        bench::doNotOptimize(found.size());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("OpenClosed/good/visible/fullScan", fullScan);
@@ -0,0 +1,30 @@
+// Single Responsibility, bad: the Invoice prints and saves itself, and keeps
+// its own copy of the customer name.
+#define main example_main
+#include "../SOLID/Single-Responsibility/bad_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void printAndSave(bench::State& state) {
+    Invoice invoice("Ahmed", 250.0);
+    while (state.keepRunning()) {
+        invoice.printInvoice();
+        invoice.saveToFile();
+    }
+    remove("invoice.txt");
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("SingleResponsibility/bad/printAndSave", printAndSave);
+
+static void newInvoice(bench::State& state) {
+    const string customer = "Customer 42";
+    double amount = 0;
+    while (state.keepRunning()) {
+        Invoice invoice(customer, amount += 1.0);
+        bench::doNotOptimize(invoice);
+    }
+    state.counters["bytes/Invoice"] = sizeof(Invoice);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("SingleResponsibility/bad/newInvoice", newInvoice);
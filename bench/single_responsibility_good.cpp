@@ -0,0 +1,210 @@
+// Single Responsibility, good: an Invoice only holds data, and printing,
+// saving and totaling live in their own classes. Also times the batch savers
+// and printers, the column format and the totals built on that split.
+#define main example_main
+#include "../SOLID/Single-Responsibility/good_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+// The same invoices for every benchmark: 100 customers, amounts up to $2000
+static vector<Invoice> makeInvoices(size_t count) {
+    vector<Invoice> invoices;
+    invoices.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        invoices.emplace_back("Customer " + to_string(i % 100), (i * 7919 % 200000) / 100.0);
+    }
+    return invoices;
+}
+
+static void printAndSave(bench::State& state) {
+    Invoice invoice("Ahmed", 250.0);
+    InvoicePrinter printer;
+    InvoiceFileSaver saver;
+    while (state.keepRunning()) {
+        printer.print(invoice);
+        saver.saveToFile(invoice);
+    }
+    remove("invoice.txt");
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("SingleResponsibility/good/printAndSave", printAndSave);
+
+// range() invoices saved one file open at a time, against the batch saver
+static void saveEach(bench::State& state) {
+    vector<Invoice> invoices = makeInvoices(state.range());
+    InvoiceFileSaver saver;
+    while (state.keepRunning()) {
+        for (const Invoice& invoice : invoices) saver.saveToFile(invoice);
+    }
+    remove("invoice.txt");
+    state.setItemsProcessed(state.iterations() * invoices.size());
+}
+BENCHMARK_ARGS("SingleResponsibility/good/saveEach", saveEach, 1000);
+
+static void batchSave(bench::State& state) {
+    vector<Invoice> invoices = makeInvoices(state.range());
+    {
+        InvoiceBatchSaver saver("bench_invoices");
+        while (state.keepRunning()) {
+            for (const Invoice& invoice : invoices) saver.save(invoice);
+            saver.flush();
+        }
+    }
+    for (int file = 0; remove(("bench_invoices_" + to_string(file) + ".txt").c_str()) == 0; ++file) {
+    }
+    state.setItemsProcessed(state.iterations() * invoices.size());
+}
+BENCHMARK_ARGS("SingleResponsibility/good/batchSave", batchSave, 1000);
+
+// A report over a million invoices: invoices of $100 or more, read from the
+// column file or from the same invoices saved as text.
+static constexpr size_t kReportInvoices = 1000000;
+
+static size_t fileSize(const char* path) {
+    ifstream file(path, ios::binary | ios::ate);
+    return static_cast<size_t>(file.tellg());
+}
+
+static void columnReport(bench::State& state) {
+    const char* path = "bench_invoices.col";
+    {
+        InvoiceColumnWriter writer;
+        for (const Invoice& invoice : makeInvoices(kReportInvoices)) writer.add(invoice);
+        writer.writeToFile(path);
+    }
+    while (state.keepRunning()) {
+        InvoiceColumnReader reader;
+        if (!reader.open(path)) throw runtime_error("cannot read bench_invoices.col");
+        bench::doNotOptimize(reader.sumCentsAtLeast(10000));
+    }
+    state.setBytesProcessed(state.iterations() * fileSize(path));
+    state.counters["fileBytes"] = fileSize(path);
+    remove(path);
+}
+BENCHMARK("SingleResponsibility/good/columnReport", columnReport);
+
+// The file already read, only the scan with its block min/max skipping
+static void columnScan(bench::State& state) {
+    const char* path = "bench_invoices.col";
+    InvoiceColumnWriter writer;
+    for (const Invoice& invoice : makeInvoices(kReportInvoices)) writer.add(invoice);
+    writer.writeToFile(path);
+    InvoiceColumnReader reader;
+    if (!reader.open(path)) throw runtime_error("cannot read bench_invoices.col");
+    remove(path);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(reader.sumCentsAtLeast(10000));
+    }
+    state.setItemsProcessed(state.iterations() * reader.size());
+}
+BENCHMARK("SingleResponsibility/good/columnScan", columnScan);
+
+static void textReport(bench::State& state) {
+    const char* path = "bench_invoices.txt";
+    {
+        string text;
+        for (const Invoice& invoice : makeInvoices(kReportInvoices)) appendInvoiceText(text, invoice);
+        ofstream(path, ios::binary).write(text.data(), text.size());
+    }
+    const string_view prefix = "Amount: $";
+    while (state.keepRunning()) {
+        ifstream file(path);
+        string line;
+        int64_t total = 0;
+        while (getline(file, line)) {
+            if (line.compare(0, prefix.size(), prefix) != 0) continue;
+            double amount = 0;
+            from_chars(line.data() + prefix.size(), line.data() + line.size(), amount);
+            int64_t cents = llround(amount * 100);
+            if (cents >= 10000) total += cents;
+        }
+        bench::doNotOptimize(total);
+    }
+    state.setBytesProcessed(state.iterations() * fileSize(path));
+    state.counters["fileBytes"] = fileSize(path);
+    remove(path);
+}
+BENCHMARK("SingleResponsibility/good/textReport", textReport);
+
+// 10000 invoices printed one print() at a time, against the batch printer
+// on range() threads
+static void printEach(bench::State& state) {
+    vector<Invoice> invoices = makeInvoices(10000);
+    InvoicePrinter printer;
+    while (state.keepRunning()) {
+        for (const Invoice& invoice : invoices) printer.print(invoice);
+    }
+    state.setItemsProcessed(state.iterations() * invoices.size());
+}
+BENCHMARK("SingleResponsibility/good/printEach", printEach);
+
+static void batchPrint(bench::State& state) {
+    vector<Invoice> invoices = makeInvoices(10000);
+    string text;
+    for (const Invoice& invoice : invoices) appendInvoiceText(text, invoice);
+    InvoiceBatchPrinter printer;
+    while (state.keepRunning()) {
+        printer.print(invoices, static_cast<unsigned>(state.range()));
+    }
+    state.setItemsProcessed(state.iterations() * invoices.size());
+    state.setBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK_ARGS("SingleResponsibility/good/batchPrint", batchPrint, 1, 2, 4);
+
+// Making an invoice for a customer the pool already knows
+static void newInvoice(bench::State& state) {
+    const string customer = "Customer 42";
+    Invoice first(customer, 1.0); // from here on the pool knows the customer
+    double amount = 0;
+    while (state.keepRunning()) {
+        Invoice invoice(customer, amount += 1.0);
+        bench::doNotOptimize(invoice);
+    }
+    state.counters["bytes/Invoice"] = sizeof(Invoice);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("SingleResponsibility/good/newInvoice", newInvoice);
+
+static void customerName(bench::State& state) {
+    vector<Invoice> invoices = makeInvoices(1000);
+    size_t next = 0;
+    while (state.keepRunning()) {
+        bench::doNotOptimize(invoices[next++ % invoices.size()].getCustomerName());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("SingleResponsibility/good/customerName", customerName);
+
+// Totals over a million invoices: whole cents in a flat array, against adding
+// up the invoices' double amounts
+static void sumCents(bench::State& state) {
+    InvoiceTotals totals;
+    for (const Invoice& invoice : makeInvoices(kReportInvoices)) totals.add(invoice);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(totals.sumCents());
+    }
+    state.setItemsProcessed(state.iterations() * kReportInvoices);
+}
+BENCHMARK("SingleResponsibility/good/totals/sumCents", sumCents);
+
+static void sumAmounts(bench::State& state) {
+    vector<Invoice> invoices = makeInvoices(kReportInvoices);
+    while (state.keepRunning()) {
+        double total = 0;
+        for (const Invoice& invoice : invoices) total += invoice.getAmount();
+        bench::doNotOptimize(total);
+    }
+    state.setItemsProcessed(state.iterations() * kReportInvoices);
+}
+BENCHMARK("SingleResponsibility/good/totals/sumAmounts", sumAmounts);
+
+static void sumCentsByCustomer(bench::State& state) {
+    InvoiceTotals totals;
+    for (const Invoice& invoice : makeInvoices(kReportInvoices)) totals.add(invoice);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(totals.sumCentsByCustomer(static_cast<unsigned>(state.range())));
+    }
+    state.setItemsProcessed(state.iterations() * kReportInvoices);
+}
+BENCHMARK_ARGS("SingleResponsibility/good/totals/sumCentsByCustomer", sumCentsByCustomer, 1, 2, 4);
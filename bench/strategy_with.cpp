@@ -0,0 +1,34 @@
+// Strategy, with the pattern: the checkout keeps one gateway object and pays
+// through it. Switching gateway is one shared_ptr assignment.
+#define main example_main
+#include "../Design-Patterns/Behavioral/Strategy-Pattern/with_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static void processPayment(bench::State& state) {
+    CheckoutService checkout;
+    checkout.setGateway(make_shared<CreditCardGateway>());
+    float amount = 0.0f;
+    while (state.keepRunning()) {
+        checkout.processPayment(amount += 1.0f);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Strategy/with/processPayment", processPayment);
+
+// A different payment method for every payment
+static void switchAndPay(bench::State& state) {
+    const shared_ptr<IPaymentGateway> gateways[] = {
+        make_shared<CreditCardGateway>(), make_shared<PayPalGateway>(),
+        make_shared<CryptoGateway>(), make_shared<ApplePayGateway>()};
+    CheckoutService checkout;
+    float amount = 0.0f;
+    size_t next = 0;
+    while (state.keepRunning()) {
+        checkout.setGateway(gateways[next++ & 3]);
+        checkout.processPayment(amount += 1.0f);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Strategy/with/switchAndPay", switchAndPay);
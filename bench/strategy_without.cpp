@@ -0,0 +1,39 @@
+// Strategy, without the pattern: changing the payment method means creating a
+// new processor object, the way the example's main() does it.
+#define main example_main
+#include "../Design-Patterns/Behavioral/Strategy-Pattern/without_example.cpp"
+#undef main
+
+#include "harness/bench.h"
+
+static PaymentProcessor* newProcessor(int choice) {
+    switch (choice) {
+    case 1: return new CreditCardProcessor();
+    case 2: return new PayPalProcessor();
+    default: return new CryptoProcessor();
+    }
+}
+
+static void processPayment(bench::State& state) {
+    PaymentProcessor* processor = newProcessor(1);
+    double amount = 0.0;
+    while (state.keepRunning()) {
+        processor->processPayment(amount += 1.0);
+    }
+    delete processor;
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Strategy/without/processPayment", processPayment);
+
+// A different payment method for every payment
+static void switchAndPay(bench::State& state) {
+    double amount = 0.0;
+    int choice = 0;
+    while (state.keepRunning()) {
+        PaymentProcessor* processor = newProcessor(choice++ % 3 + 1);
+        processor->processPayment(amount += 1.0);
+        delete processor;
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK("Strategy/without/switchAndPay", switchAndPay);